@@ -28,101 +28,140 @@
 /*                                                                      */
 /************************************************************************/
 
+
 #include <benchmark/benchmark.h>
 #include <xvigra/separable_convolution.hpp>
+#include "benchmark_utils.hpp"
 
 namespace xvigra
 {
-    auto && kernel = averaging_kernel_1d<float>(1);
-
     template <class V>
     void simple_averaging_2d_no_simd(benchmark::State& state)
     {
-        array_nd<V, 2> data(shape_t<2>{2000,3000}),
-                             result(data.shape());
+        index_t s = state.range(0);
+        array_nd<V, 2> data(shape_t<2>{s, s}),
+                       result(data.shape());
+        auto kernel = averaging_kernel_1d<V>(1);
 
         for (auto _ : state)
         {
             slow_separable_convolution(data, result, kernel, convolution_options().use_simd(false));
-            benchmark::DoNotOptimize(result.data());
+            benchmark::DoNotOptimize(result.raw_data());
         }
+        set_throughput(state, data.size(), 2.0*data.size()*sizeof(V));
     }
 
-    BENCHMARK_TEMPLATE(simple_averaging_2d_no_simd, float);
+    XVIGRA_BENCHMARK_2D(simple_averaging_2d_no_simd, float);
 
     template <class V>
     void simple_averaging_2d_simd(benchmark::State& state)
     {
-        array_nd<V, 2> data(shape_t<2>{2000,3000}),
-                             result(data.shape());
+        index_t s = state.range(0);
+        array_nd<V, 2> data(shape_t<2>{s, s}),
+                       result(data.shape());
+        auto kernel = averaging_kernel_1d<V>(1);
 
         for (auto _ : state)
         {
             slow_separable_convolution(data, result, kernel, convolution_options().use_simd(true));
-            benchmark::DoNotOptimize(result.data());
+            benchmark::DoNotOptimize(result.raw_data());
         }
+        set_throughput(state, data.size(), 2.0*data.size()*sizeof(V));
     }
 
-    BENCHMARK_TEMPLATE(simple_averaging_2d_simd, float);
+    XVIGRA_BENCHMARK_2D(simple_averaging_2d_simd, float);
 
     template <class V>
     void averaging_2d_no_simd(benchmark::State& state)
     {
-        array_nd<V, 2> data(shape_t<2>{2000,3000}),
-                             result(data.shape());
+        index_t s = state.range(0);
+        array_nd<V, 2> data(shape_t<2>{s, s}),
+                       result(data.shape());
+        auto kernel = averaging_kernel_1d<V>(1);
 
         for (auto _ : state)
         {
             separable_convolution_functor()(data, result, kernel, convolution_options().use_simd(false));
-            benchmark::DoNotOptimize(result.data());
+            benchmark::DoNotOptimize(result.raw_data());
         }
+        set_throughput(state, data.size(), 2.0*data.size()*sizeof(V));
     }
 
-    BENCHMARK_TEMPLATE(averaging_2d_no_simd, float);
+    XVIGRA_BENCHMARK_2D(averaging_2d_no_simd, float);
+    XVIGRA_BENCHMARK_2D(averaging_2d_no_simd, double);
 
     template <class V>
     void averaging_2d_simd(benchmark::State& state)
     {
-        array_nd<V, 2> data(shape_t<2>{2000,3000}),
-                             result(data.shape());
+        index_t s = state.range(0);
+        array_nd<V, 2> data(shape_t<2>{s, s}),
+                       result(data.shape());
+        auto kernel = averaging_kernel_1d<V>(1);
 
         for (auto _ : state)
         {
             separable_convolution_functor()(data, result, kernel, convolution_options().use_simd(true));
-            benchmark::DoNotOptimize(result.data());
+            benchmark::DoNotOptimize(result.raw_data());
+        }
+        set_throughput(state, data.size(), 2.0*data.size()*sizeof(V));
+    }
+
+    XVIGRA_BENCHMARK_2D(averaging_2d_simd, float);
+    XVIGRA_BENCHMARK_2D(averaging_2d_simd, double);
+
+    template <class V>
+    void averaging_2d_rgb(benchmark::State& state)
+    {
+        index_t s = state.range(0);
+        array_nd<V, 3> data(shape_t<3>{s, s, 3}),
+                       result(data.shape());
+        auto kernel = averaging_kernel_1d<V>(1);
+
+        for (auto _ : state)
+        {
+            separable_convolution_functor()(2_d, data, result, kernel);
+            benchmark::DoNotOptimize(result.raw_data());
         }
+        set_throughput(state, s*s, 2.0*data.size()*sizeof(V));
     }
 
-    BENCHMARK_TEMPLATE(averaging_2d_simd, float);
+    XVIGRA_BENCHMARK_2D(averaging_2d_rgb, float);
 
     template <class V>
     void averaging_3d_no_simd(benchmark::State& state)
     {
-        array_nd<V, 3> data(shape_t<3>{100,200,300}),
-                             result(data.shape());
+        index_t s = state.range(0);
+        array_nd<V, 3> data(shape_t<3>{s, s, s}),
+                       result(data.shape());
+        auto kernel = averaging_kernel_1d<V>(1);
 
         for (auto _ : state)
         {
             separable_convolution_functor()(data, result, kernel, convolution_options().use_simd(false));
-            benchmark::DoNotOptimize(result.data());
+            benchmark::DoNotOptimize(result.raw_data());
         }
+        set_throughput(state, data.size(), 2.0*data.size()*sizeof(V));
     }
 
-    BENCHMARK_TEMPLATE(averaging_3d_no_simd, float);
+    XVIGRA_BENCHMARK_3D(averaging_3d_no_simd, float);
 
     template <class V>
     void averaging_3d_simd(benchmark::State& state)
     {
-        array_nd<V, 3> data(shape_t<3>{100,200,300}),
-                             result(data.shape());
+        index_t s = state.range(0);
+        array_nd<V, 3> data(shape_t<3>{s, s, s}),
+                       result(data.shape());
+        auto kernel = averaging_kernel_1d<V>(1);
 
         for (auto _ : state)
         {
             separable_convolution_functor()(data, result, kernel, convolution_options().use_simd(true));
-            benchmark::DoNotOptimize(result.data());
+            benchmark::DoNotOptimize(result.raw_data());
         }
+        set_throughput(state, data.size(), 2.0*data.size()*sizeof(V));
     }
 
-    BENCHMARK_TEMPLATE(averaging_3d_simd, float);
+    XVIGRA_BENCHMARK_3D(averaging_3d_simd, float);
+    XVIGRA_BENCHMARK_3D(averaging_3d_simd, double);
 
 } // namespace xvigra
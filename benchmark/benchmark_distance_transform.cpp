@@ -0,0 +1,85 @@
+/************************************************************************/
+/*                                                                      */
+/*     Copyright 2017-2018 by Ullrich Koethe                            */
+/*                                                                      */
+/*    This file is part of the XVIGRA image analysis library.           */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+
+#include <benchmark/benchmark.h>
+#include <xvigra/distance_transform.hpp>
+#include "benchmark_utils.hpp"
+
+namespace xvigra
+{
+        // binary image with a sparse grid of background points
+    template <class T, index_t N>
+    array_nd<T, N> distance_transform_input(shape_t<N> const & shape)
+    {
+        array_nd<T, N> res(shape, T(1));
+        for(index_t k = 0; k < res.size(); k += 97)
+        {
+            res[k] = T(0);
+        }
+        return res;
+    }
+
+    template <class V>
+    void distance_transform_2d(benchmark::State& state)
+    {
+        index_t s = state.range(0);
+        auto data = distance_transform_input<uint8_t>(shape_t<2>{s, s});
+        array_nd<V, 2> result(data.shape());
+
+        for (auto _ : state)
+        {
+            distance_transform_squared(data, result);
+            benchmark::DoNotOptimize(result.raw_data());
+        }
+        set_throughput(state, data.size(), data.size()*(sizeof(uint8_t) + sizeof(V)));
+    }
+
+    XVIGRA_BENCHMARK_2D(distance_transform_2d, float);
+    XVIGRA_BENCHMARK_2D(distance_transform_2d, double);
+
+    template <class V>
+    void distance_transform_3d(benchmark::State& state)
+    {
+        index_t s = state.range(0);
+        auto data = distance_transform_input<uint8_t>(shape_t<3>{s, s, s});
+        array_nd<V, 3> result(data.shape());
+
+        for (auto _ : state)
+        {
+            distance_transform_squared(data, result);
+            benchmark::DoNotOptimize(result.raw_data());
+        }
+        set_throughput(state, data.size(), data.size()*(sizeof(uint8_t) + sizeof(V)));
+    }
+
+    XVIGRA_BENCHMARK_3D(distance_transform_3d, float);
+
+} // namespace xvigra
@@ -162,8 +162,6 @@ namespace xvigra
         auto data = xt::xarray<V>::from_shape({SIZE});
         auto view = xt::dynamic_view(data, xt::slice_vector{xt::all()});
 
-        std::cerr << typeid(xt::zeros<V>({SIZE})).name() << "\n";
-
         for (auto _ : state)
         {
             view = xt::zeros<V>({SIZE});
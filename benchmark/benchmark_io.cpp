@@ -0,0 +1,103 @@
+/************************************************************************/
+/*                                                                      */
+/*     Copyright 2017-2018 by Ullrich Koethe                            */
+/*                                                                      */
+/*    This file is part of the XVIGRA image analysis library.           */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+
+#include <cstdio>
+#include <benchmark/benchmark.h>
+#include <xvigra/image_io.hpp>
+#include <xvigra/array_io.hpp>
+#include "benchmark_utils.hpp"
+
+namespace xvigra
+{
+    template <class V>
+    void image_io_tiff(benchmark::State& state)
+    {
+        index_t s = state.range(0);
+        array_nd<V, 3> data(shape_t<3>{s, s, 3}, V(1)),
+                       result(data.shape());
+        std::string filename = "benchmark_image_io.tif";
+
+        for (auto _ : state)
+        {
+            write_image(filename, data);
+            read_image_into(filename, result);
+            benchmark::DoNotOptimize(result.raw_data());
+        }
+        set_throughput(state, s*s, 2.0*data.size()*sizeof(V));
+        std::remove(filename.c_str());
+    }
+
+    XVIGRA_BENCHMARK_2D(image_io_tiff, uint8_t);
+    XVIGRA_BENCHMARK_2D(image_io_tiff, float);
+
+    template <class V>
+    void array_io_npy(benchmark::State& state)
+    {
+        index_t s = state.range(0);
+        array_nd<V, 3> data(shape_t<3>{s, s, s}, V(1)),
+                       result(data.shape());
+        std::string filename = "benchmark_array_io.npy";
+
+        for (auto _ : state)
+        {
+            write_npy(filename, data);
+            read_npy_into(filename, result);
+            benchmark::DoNotOptimize(result.raw_data());
+        }
+        set_throughput(state, data.size(), 2.0*data.size()*sizeof(V));
+        std::remove(filename.c_str());
+    }
+
+    XVIGRA_BENCHMARK_3D(array_io_npy, uint16_t);
+    XVIGRA_BENCHMARK_3D(array_io_npy, float);
+
+    template <class V>
+    void array_io_chunked(benchmark::State& state)
+    {
+        index_t s = state.range(0);
+        array_nd<V, 3> data(shape_t<3>{s, s, s}, V(1)),
+                       result(data.shape());
+        std::string filename = "benchmark_array_io.xvc";
+        auto options = chunked_options().chunks(shape_t<>{32, 32, 32});
+
+        for (auto _ : state)
+        {
+            write_chunked(filename, data, options);
+            read_chunked_into(filename, result);
+            benchmark::DoNotOptimize(result.raw_data());
+        }
+        set_throughput(state, data.size(), 2.0*data.size()*sizeof(V));
+        std::remove(filename.c_str());
+    }
+
+    XVIGRA_BENCHMARK_3D(array_io_chunked, float);
+
+} // namespace xvigra
@@ -0,0 +1,69 @@
+/************************************************************************/
+/*                                                                      */
+/*     Copyright 2017-2018 by Ullrich Koethe                            */
+/*                                                                      */
+/*    This file is part of the XVIGRA image analysis library.           */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <xvigra/splines.hpp>
+#include "benchmark_utils.hpp"
+
+namespace xvigra
+{
+    template <class SPLINE>
+    void b_spline_evaluation(benchmark::State& state)
+    {
+        using value_type = typename SPLINE::value_type;
+        index_t size = state.range(0);
+        SPLINE spline;
+        value_type r = spline.radius();
+        std::vector<value_type> x(size), y(size);
+        for(index_t k = 0; k < size; ++k)
+        {
+            x[k] = -r + 2.0*r*k / size;
+        }
+
+        for (auto _ : state)
+        {
+            for(index_t k = 0; k < size; ++k)
+            {
+                y[k] = spline(x[k]);
+            }
+            benchmark::DoNotOptimize(y.data());
+        }
+        set_throughput(state, size, 2.0*size*sizeof(value_type));
+    }
+
+    BENCHMARK_TEMPLATE(b_spline_evaluation, b_spline<1, float>)->Arg(1 << 16);
+    BENCHMARK_TEMPLATE(b_spline_evaluation, b_spline<2, float>)->Arg(1 << 16);
+    BENCHMARK_TEMPLATE(b_spline_evaluation, b_spline<3, float>)->Arg(1 << 16);
+    BENCHMARK_TEMPLATE(b_spline_evaluation, b_spline<3, double>)->Arg(1 << 16);
+    BENCHMARK_TEMPLATE(b_spline_evaluation, b_spline<5, double>)->Arg(1 << 16);
+
+} // namespace xvigra
@@ -67,7 +67,78 @@ namespace xvigra
         }
     }
 
+    template <class V>
+    V bm_tiny_vector_init(typename V::value_type offset)
+    {
+        V res(dont_init);
+        for (index_t i = 0; i < res.size(); ++i)
+        {
+            res[i] = typename V::value_type(i + offset);
+        }
+        return res;
+    }
+
+    template <class V>
+    void bm_tiny_vector_norm_sq(benchmark::State& state)
+    {
+        V a = bm_tiny_vector_init<V>(1);
+
+        for (auto _ : state)
+        {
+            auto result = norm_sq(a);
+            benchmark::DoNotOptimize(result);
+            benchmark::DoNotOptimize(a.data());
+        }
+    }
+
+    template <class V>
+    void bm_tiny_vector_dot(benchmark::State& state)
+    {
+        V a = bm_tiny_vector_init<V>(1);
+        V b = bm_tiny_vector_init<V>(2);
+
+        for (auto _ : state)
+        {
+            auto result = dot(a, b);
+            benchmark::DoNotOptimize(result);
+            benchmark::DoNotOptimize(a.data());
+            benchmark::DoNotOptimize(b.data());
+        }
+    }
+
+    template <class V>
+    void bm_tiny_vector_cross(benchmark::State& state)
+    {
+        V a = bm_tiny_vector_init<V>(1);
+        V b = bm_tiny_vector_init<V>(2);
+
+        for (auto _ : state)
+        {
+            V result = cross(a, b);
+            benchmark::DoNotOptimize(result.data());
+            benchmark::DoNotOptimize(a.data());
+            benchmark::DoNotOptimize(b.data());
+        }
+    }
+
     BENCHMARK_TEMPLATE(bm_tiny_vector_loop, tiny_vector<index_t, 4>);
     BENCHMARK_TEMPLATE(bm_tiny_vector_plus, tiny_vector<index_t, 4>);
+    BENCHMARK_TEMPLATE(bm_tiny_vector_loop, tiny_vector<float, 4>);
+    BENCHMARK_TEMPLATE(bm_tiny_vector_plus, tiny_vector<float, 4>);
+    BENCHMARK_TEMPLATE(bm_tiny_vector_plus, tiny_vector<double, 4>);
+
+    BENCHMARK_TEMPLATE(bm_tiny_vector_norm_sq, tiny_vector<float, 3>);
+    BENCHMARK_TEMPLATE(bm_tiny_vector_norm_sq, tiny_vector<float, 4>);
+    BENCHMARK_TEMPLATE(bm_tiny_vector_norm_sq, tiny_vector<float, 8>);
+    BENCHMARK_TEMPLATE(bm_tiny_vector_norm_sq, tiny_vector<double, 3>);
+
+    BENCHMARK_TEMPLATE(bm_tiny_vector_dot, tiny_vector<float, 3>);
+    BENCHMARK_TEMPLATE(bm_tiny_vector_dot, tiny_vector<float, 4>);
+    BENCHMARK_TEMPLATE(bm_tiny_vector_dot, tiny_vector<float, 8>);
+    BENCHMARK_TEMPLATE(bm_tiny_vector_dot, tiny_vector<double, 2>);
+    BENCHMARK_TEMPLATE(bm_tiny_vector_dot, tiny_vector<double, 3>);
+
+    BENCHMARK_TEMPLATE(bm_tiny_vector_cross, tiny_vector<float, 3>);
+    BENCHMARK_TEMPLATE(bm_tiny_vector_cross, tiny_vector<double, 3>);
 
 } // namespace xvigra
@@ -0,0 +1,67 @@
+/************************************************************************/
+/*                                                                      */
+/*     Copyright 2017-2018 by Ullrich Koethe                            */
+/*                                                                      */
+/*    This file is part of the XVIGRA image analysis library.           */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+
+#ifndef XVIGRA_BENCHMARK_UTILS_HPP
+#define XVIGRA_BENCHMARK_UTILS_HPP
+
+#include <benchmark/benchmark.h>
+#include <xvigra/global.hpp>
+
+namespace xvigra
+{
+        /** Attach throughput counters to a benchmark, given the number of pixels
+            processed and the number of bytes read plus written per iteration.
+            The counters "MPix/s" and "GB/s" appear in the console table and in
+            the JSON output (see the 'xbench_json' target), so that regressions
+            can be tracked independently of the image size.
+        */
+    inline void
+    set_throughput(benchmark::State & state, double pixels, double bytes)
+    {
+        state.SetItemsProcessed(state.iterations() * (int64_t)pixels);
+        state.SetBytesProcessed(state.iterations() * (int64_t)bytes);
+        state.counters["MPix/s"] = benchmark::Counter(1e-6*pixels, benchmark::Counter::kIsIterationInvariantRate);
+        state.counters["GB/s"]   = benchmark::Counter(1e-9*bytes,  benchmark::Counter::kIsIterationInvariantRate);
+    }
+
+        // image sizes used throughout the suite: side lengths of 2D and 3D arrays
+    constexpr index_t bench_min_size_2d = 256, bench_max_size_2d = 4096;
+    constexpr index_t bench_min_size_3d = 32,  bench_max_size_3d = 256;
+
+} // namespace xvigra
+
+#define XVIGRA_BENCHMARK_2D(NAME, ...) \
+    BENCHMARK_TEMPLATE(NAME, __VA_ARGS__)->RangeMultiplier(4)->Range(xvigra::bench_min_size_2d, xvigra::bench_max_size_2d)->Unit(benchmark::kMillisecond)
+
+#define XVIGRA_BENCHMARK_3D(NAME, ...) \
+    BENCHMARK_TEMPLATE(NAME, __VA_ARGS__)->RangeMultiplier(2)->Range(xvigra::bench_min_size_3d, xvigra::bench_max_size_3d)->Unit(benchmark::kMillisecond)
+
+#endif // XVIGRA_BENCHMARK_UTILS_HPP
@@ -33,17 +33,12 @@
 #include <xtensor/xstrided_view.hpp>
 #include <xtensor/xnoalias.hpp>
 #include <xvigra/global.hpp>
+#include <xvigra/array_nd.hpp>
 
 #ifdef BENCHMARK_VIGRA
 #  include <vigra/multi_array.hxx>
 #endif
 
-#define BENCHMARK_VIGRA2
-
-#ifdef BENCHMARK_VIGRA2
-#  include <vigra2/array_nd.hxx>
-#endif
-
 static const int SIZE = 1000;
 
 #ifdef BENCHMARK_VIGRA
@@ -136,140 +131,138 @@ namespace vigra
 
 #endif // BENCHMARK_VIGRA
 
-#ifdef BENCHMARK_VIGRA2
-namespace vigra
+namespace xvigra
 {
     template <class V>
-    void vigra2_iterator(benchmark::State& state)
+    void xvigra_iterator(benchmark::State& state)
     {
-        ArrayND<2, V> data(Shape<>{SIZE, SIZE}, 1);
-        ArrayND<1, V> res(Shape<>{SIZE}, 1);
+        array_nd<V, 2> data(shape_t<2>{SIZE, SIZE}, V(1));
+        array_nd<V, 1> res(shape_t<1>{SIZE}, V(1));
 
         auto v = data.bind(1, SIZE/2);
         for (auto _ : state)
         {
             std::copy(v.begin(), v.end(), res.begin());
-            benchmark::DoNotOptimize(res.data());
+            benchmark::DoNotOptimize(res.raw_data());
         }
     }
 
     template <class V>
-    void vigra2_dynamic_iterator(benchmark::State& state)
+    void xvigra_dynamic_iterator(benchmark::State& state)
     {
-        ArrayND<runtime_size, V> data(Shape<>{SIZE, SIZE}, 1);
-        ArrayND<runtime_size, V> res(Shape<>{SIZE}, 1);
+        array_nd<V> data(shape_t<>{SIZE, SIZE}, V(1));
+        array_nd<V> res(shape_t<>{SIZE}, V(1));
 
         auto v = data.bind(1, SIZE/2);
         for (auto _ : state)
         {
             std::copy(v.begin(), v.end(), res.begin());
-            benchmark::DoNotOptimize(res.data());
+            benchmark::DoNotOptimize(res.raw_data());
         }
     }
 
     template <class V>
-    void vigra2_loop(benchmark::State& state)
+    void xvigra_loop(benchmark::State& state)
     {
-        ArrayND<2, V> data(Shape<>{SIZE, SIZE}, 1);
-        ArrayND<1, V> res(Shape<>{SIZE}, 1);
+        array_nd<V, 2> data(shape_t<2>{SIZE, SIZE}, V(1));
+        array_nd<V, 1> res(shape_t<1>{SIZE}, V(1));
 
         auto v = data.bind(1, SIZE/2);
         for (auto _ : state)
         {
-            for(int k=0; k<v.shape()[0]; ++k)
+            for(index_t k=0; k<v.shape()[0]; ++k)
             {
                 res(k) = v(k);
             }
-            benchmark::DoNotOptimize(res.data());
+            benchmark::DoNotOptimize(res.raw_data());
         }
     }
 
     template <class V>
-    void vigra2_dynamic_loop(benchmark::State& state)
+    void xvigra_dynamic_loop(benchmark::State& state)
     {
-        ArrayND<runtime_size, V> data(Shape<>{SIZE, SIZE}, 1);
-        ArrayND<runtime_size, V> res(Shape<>{SIZE}, 1);
+        array_nd<V> data(shape_t<>{SIZE, SIZE}, V(1));
+        array_nd<V> res(shape_t<>{SIZE}, V(1));
 
         auto v = data.bind(1, SIZE/2);
         for (auto _ : state)
         {
-            for(int k=0; k<v.shape()[0]; ++k)
+            for(index_t k=0; k<v.shape()[0]; ++k)
             {
                 res(k) = v(k);
             }
-            benchmark::DoNotOptimize(res.data());
+            benchmark::DoNotOptimize(res.raw_data());
         }
     }
 
     template <class V>
-    void vigra2_assign(benchmark::State& state)
+    void xvigra_assign(benchmark::State& state)
     {
-        ArrayND<2, V> data(Shape<>{SIZE, SIZE}, 1);
-        ArrayND<1, V> res(Shape<>{SIZE}, 1);
+        array_nd<V, 2> data(shape_t<2>{SIZE, SIZE}, V(1));
+        array_nd<V, 1> res(shape_t<1>{SIZE}, V(1));
 
         auto v = data.bind(1, SIZE/2);
         for (auto _ : state)
         {
             res = v;
-            benchmark::DoNotOptimize(res.data());
+            benchmark::DoNotOptimize(res.raw_data());
         }
     }
 
     template <class V>
-    void vigra2_dynamic_assign(benchmark::State& state)
+    void xvigra_dynamic_assign(benchmark::State& state)
     {
-        ArrayND<runtime_size, V> data(Shape<>{SIZE, SIZE}, 1);
-        ArrayND<runtime_size, V> res(Shape<>{SIZE}, 1);
+        array_nd<V> data(shape_t<>{SIZE, SIZE}, V(1));
+        array_nd<V> res(shape_t<>{SIZE}, V(1));
 
         auto v = data.bind(1, SIZE/2);
         for (auto _ : state)
         {
             res = v;
-            benchmark::DoNotOptimize(res.data());
+            benchmark::DoNotOptimize(res.raw_data());
         }
     }
 
     template <class V>
-    void vigra2_assign_view(benchmark::State& state)
+    void xvigra_assign_view(benchmark::State& state)
     {
-        ArrayND<2, V> data(Shape<>{SIZE, SIZE}, 1);
-        ArrayND<1, V> res(Shape<>{SIZE}, 1);
+        array_nd<V, 2> data(shape_t<2>{SIZE, SIZE}, V(1));
+        array_nd<V, 1> res(shape_t<1>{SIZE}, V(1));
 
         auto v = data.bind(1, SIZE/2);
-        auto r = res.subarray(Shape<>{0}, Shape<>{SIZE});
+        auto r = res.subarray(shape_t<1>{0}, shape_t<1>{SIZE});
         for (auto _ : state)
         {
             r = v;
-            benchmark::DoNotOptimize(r.data());
+            benchmark::DoNotOptimize(r.raw_data());
         }
     }
 
     template <class V>
-    void vigra2_dynamic_assign_view(benchmark::State& state)
+    void xvigra_dynamic_assign_view(benchmark::State& state)
     {
-        ArrayND<runtime_size, V> data(Shape<>{SIZE, SIZE}, 1);
-        ArrayND<runtime_size, V> res(Shape<>{SIZE}, 1);
+        array_nd<V> data(shape_t<>{SIZE, SIZE}, V(1));
+        array_nd<V> res(shape_t<>{SIZE}, V(1));
 
         auto v = data.bind(1, SIZE/2);
-        auto r = res.subarray(Shape<>{0}, Shape<>{SIZE});
+        auto r = res.subarray(shape_t<>{0}, shape_t<>{SIZE});
         for (auto _ : state)
         {
             r = v;
-            benchmark::DoNotOptimize(r.data());
+            benchmark::DoNotOptimize(r.raw_data());
         }
     }
 
-    BENCHMARK_TEMPLATE(vigra2_iterator, float);
-    BENCHMARK_TEMPLATE(vigra2_dynamic_iterator, float);
-    BENCHMARK_TEMPLATE(vigra2_loop, float);
-    BENCHMARK_TEMPLATE(vigra2_dynamic_loop, float);
-    BENCHMARK_TEMPLATE(vigra2_assign, float);
-    BENCHMARK_TEMPLATE(vigra2_dynamic_assign, float);
-    BENCHMARK_TEMPLATE(vigra2_assign_view, float);
-    BENCHMARK_TEMPLATE(vigra2_dynamic_assign_view, float);
+    BENCHMARK_TEMPLATE(xvigra_iterator, float);
+    BENCHMARK_TEMPLATE(xvigra_dynamic_iterator, float);
+    BENCHMARK_TEMPLATE(xvigra_loop, float);
+    BENCHMARK_TEMPLATE(xvigra_dynamic_loop, float);
+    BENCHMARK_TEMPLATE(xvigra_assign, float);
+    BENCHMARK_TEMPLATE(xvigra_dynamic_assign, float);
+    BENCHMARK_TEMPLATE(xvigra_assign_view, float);
+    BENCHMARK_TEMPLATE(xvigra_dynamic_assign_view, float);
 
-} // namespace vigra
-#endif // BENCHMARK_VIGRA2
+} // namespace xvigra
 
 namespace xvigra
 {
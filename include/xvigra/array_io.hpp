@@ -0,0 +1,873 @@
+/************************************************************************/
+/*                                                                      */
+/*     Copyright 2017-2018 by Ullrich Koethe                            */
+/*                                                                      */
+/*    This file is part of the XVIGRA image analysis library.           */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+
+#ifndef XVIGRA_ARRAY_IO_HPP
+#define XVIGRA_ARRAY_IO_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #define XVIGRA_HAS_MMAP
+#endif
+
+#ifdef XVIGRA_USE_ZLIB
+    #include <zlib.h>
+#endif
+
+#include "global.hpp"
+#include "error.hpp"
+#include "array_nd.hpp"
+#include "parallel.hpp"
+
+namespace xvigra
+{
+    /*********************/
+    /* low-level helpers */
+    /*********************/
+
+    namespace detail
+    {
+        inline bool is_little_endian()
+        {
+            std::uint16_t v = 1;
+            return *reinterpret_cast<unsigned char const *>(&v) == 1;
+        }
+
+            // type code of 'T' in NumPy's array protocol (e.g. "<f4" for float)
+        template <class T>
+        std::string npy_descr()
+        {
+            static_assert(std::is_arithmetic<T>::value,
+                "npy_descr<T>(): T must be an arithmetic type.");
+            char kind = std::is_same<T, bool>::value
+                          ? 'b'
+                          : std::is_floating_point<T>::value
+                              ? 'f'
+                              : std::is_signed<T>::value
+                                  ? 'i'
+                                  : 'u';
+            return std::string(sizeof(T) == 1 ? "|" : "<") + kind + std::to_string(sizeof(T));
+        }
+
+            // true if the elements of 'v' are consecutive in C order
+        template <class T, index_t N>
+        bool is_c_order(view_nd<T, N> const & v)
+        {
+            index_t stride = 1;
+            for(index_t k = (index_t)v.dimension() - 1; k >= 0; --k)
+            {
+                if(v.shape(k) == 1)
+                    continue;
+                if(v.strides(k) != stride)
+                    return false;
+                stride *= v.shape(k);
+            }
+            return true;
+        }
+
+            // Write the elements of 'v' in C order. Non-consecutive arrays are
+            // written line by line via a buffer, so no copy of the array is made.
+        template <class T, index_t N>
+        void write_c_order(std::ostream & out, view_nd<T, N> const & v, std::string const & caller)
+        {
+            using value_type = std::remove_const_t<T>;
+            if(is_c_order(v))
+            {
+                out.write(reinterpret_cast<char const *>(v.raw_data()), v.size()*sizeof(T));
+            }
+            else
+            {
+                index_t axis = v.dimension() - 1;
+                std::vector<value_type> buffer(v.shape(axis));
+                for(auto line = v.lines(axis); line.has_more(); ++line)
+                {
+                    T const * p = line.data();
+                    for(index_t k = 0; k < line.length(); ++k, p += line.stride())
+                    {
+                        buffer[k] = *p;
+                    }
+                    out.write(reinterpret_cast<char const *>(buffer.data()), buffer.size()*sizeof(T));
+                }
+            }
+            vigra_precondition(!!out, caller + "(): write error.");
+        }
+
+            // Read the elements of 'v' in C order (the counterpart of 'write_c_order()').
+        template <class T, index_t N>
+        void read_c_order(std::istream & in, view_nd<T, N> v, std::string const & caller)
+        {
+            if(is_c_order(v))
+            {
+                in.read(reinterpret_cast<char *>(v.raw_data()), v.size()*sizeof(T));
+            }
+            else
+            {
+                index_t axis = v.dimension() - 1;
+                std::vector<T> buffer(v.shape(axis));
+                for(auto line = v.lines(axis); line.has_more() && in; ++line)
+                {
+                    in.read(reinterpret_cast<char *>(buffer.data()), buffer.size()*sizeof(T));
+                    T * p = line.data();
+                    for(index_t k = 0; k < line.length(); ++k, p += line.stride())
+                    {
+                        *p = buffer[k];
+                    }
+                }
+            }
+            vigra_precondition(!!in, caller + "(): file is too short.");
+        }
+
+        inline std::ofstream open_output_file(std::string const & filename, std::string const & caller)
+        {
+            std::ofstream out(filename, std::ios::binary);
+            vigra_precondition(!!out,
+                caller + "(): Unable to open file '" + filename + "' for writing.");
+            return out;
+        }
+
+        inline std::ifstream open_input_file(std::string const & filename, std::string const & caller)
+        {
+            std::ifstream in(filename, std::ios::binary);
+            vigra_precondition(!!in,
+                caller + "(): Unable to open file '" + filename + "'.");
+            return in;
+        }
+
+        /***************/
+        /* mapped_file */
+        /***************/
+
+            // Read-only view of a file's contents, using a private memory mapping
+            // where available and a heap copy otherwise. The mapped memory is
+            // writable, but changes are never written back to the file.
+        class mapped_file
+        {
+          public:
+            mapped_file(std::string const & filename, std::string const & caller)
+            : data_(nullptr)
+            , size_(0)
+            {
+#ifdef XVIGRA_HAS_MMAP
+                int fd = ::open(filename.c_str(), O_RDONLY);
+                vigra_precondition(fd >= 0,
+                    caller + "(): Unable to open file '" + filename + "'.");
+                struct stat info;
+                if(::fstat(fd, &info) == 0)
+                {
+                    size_ = (std::size_t)info.st_size;
+                }
+                if(size_ > 0)
+                {
+                    void * p = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+                    data_ = (p == MAP_FAILED) ? nullptr : static_cast<char *>(p);
+                }
+                ::close(fd);
+                vigra_precondition(size_ == 0 || data_ != nullptr,
+                    caller + "(): Unable to map file '" + filename + "'.");
+#else
+                std::ifstream in = open_input_file(filename, caller);
+                in.seekg(0, std::ios::end);
+                buffer_.resize((std::size_t)in.tellg());
+                in.seekg(0, std::ios::beg);
+                in.read(buffer_.data(), buffer_.size());
+                vigra_precondition(!!in,
+                    caller + "(): Unable to read file '" + filename + "'.");
+                data_ = buffer_.data();
+                size_ = buffer_.size();
+#endif
+            }
+
+            ~mapped_file()
+            {
+#ifdef XVIGRA_HAS_MMAP
+                if(data_)
+                    ::munmap(data_, size_);
+#endif
+            }
+
+            mapped_file(mapped_file const &) = delete;
+            mapped_file & operator=(mapped_file const &) = delete;
+
+            char * data() const
+            {
+                return data_;
+            }
+
+            std::size_t size() const
+            {
+                return size_;
+            }
+
+          private:
+            char * data_;
+            std::size_t size_;
+#ifndef XVIGRA_HAS_MMAP
+            std::vector<char> buffer_;
+#endif
+        };
+    } // namespace detail
+
+    /***********************/
+    /* raw binary format   */
+    /***********************/
+
+    /**
+     * Write the elements of an array to a headerless binary file
+     * in C order and native byte order.
+     */
+    template <class T, index_t N>
+    void write_raw(std::string filename, view_nd<T, N> const & data)
+    {
+        auto out = detail::open_output_file(filename, "write_raw");
+        detail::write_c_order(out, data, "write_raw");
+    }
+
+    /**
+     * Read the elements of a headerless binary file (C order, native byte order)
+     * into a caller-provided array with arbitrary strides, starting at byte
+     * position ``offset``.
+     */
+    template <class T, index_t N>
+    void read_raw_into(std::string filename, view_nd<T, N> out, std::size_t offset = 0)
+    {
+        auto in = detail::open_input_file(filename, "read_raw_into");
+        in.seekg(offset);
+        detail::read_c_order(in, out, "read_raw_into");
+    }
+
+    /**************/
+    /* NPY format */
+    /**************/
+
+    namespace detail
+    {
+        struct npy_header
+        {
+            std::string descr;
+            bool fortran_order = false;
+            shape_t<> shape;
+            std::size_t data_offset = 0;
+        };
+
+            // complete header of a version 1.0 .npy file, padded to a multiple of 64 bytes
+        inline std::string npy_header_string(std::string const & descr, shape_t<> const & shape)
+        {
+            std::ostringstream dict;
+            dict << "{'descr': '" << descr << "', 'fortran_order': False, 'shape': (";
+            for(auto s: shape)
+            {
+                dict << s << ", ";
+            }
+            dict << "), }";
+            std::string d = dict.str();
+            std::size_t total = 10 + d.size() + 1;
+            d.append((64 - total % 64) % 64, ' ');
+            d.push_back('\n');
+
+            std::string header("\x93NUMPY\x01\x00", 8);
+            header.push_back(char(d.size() & 0xff));
+            header.push_back(char((d.size() >> 8) & 0xff));
+            return header + d;
+        }
+
+            // the text following 'key' in a Python dict literal
+        inline std::size_t npy_find_key(std::string const & dict, std::string const & key)
+        {
+            std::size_t pos = dict.find("'" + key + "'");
+            vigra_precondition(pos != std::string::npos,
+                "read_npy(): header doesn't contain '" + key + "'.");
+            pos = dict.find(':', pos);
+            vigra_precondition(pos != std::string::npos,
+                "read_npy(): malformed header.");
+            return dict.find_first_not_of(' ', pos + 1);
+        }
+
+            // Check the magic string and version of a .npy file and determine
+            // the position of the header dict. 'data' must hold at least 12 bytes
+            // (only 10 bytes are needed for version 1.0 files).
+        inline void npy_dict_extent(char const * data, std::size_t size,
+                                    std::size_t & start, std::size_t & length)
+        {
+            vigra_precondition(size >= 10 && std::string(data, 6) == "\x93NUMPY",
+                "read_npy(): not a .npy file.");
+            unsigned char const * d = reinterpret_cast<unsigned char const *>(data);
+            if(d[6] == 1)
+            {
+                start  = 10;
+                length = d[8] | ((std::size_t)d[9] << 8);
+            }
+            else
+            {
+                vigra_precondition((d[6] == 2 || d[6] == 3) && size >= 12,
+                    "read_npy(): unsupported file format version.");
+                start  = 12;
+                length = d[8] | ((std::size_t)d[9] << 8) | ((std::size_t)d[10] << 16) | ((std::size_t)d[11] << 24);
+            }
+        }
+
+            // Parse the header at the beginning of 'data' (which holds 'size' bytes).
+        inline npy_header parse_npy_header(char const * data, std::size_t size)
+        {
+            std::size_t start, length;
+            npy_dict_extent(data, size, start, length);
+            vigra_precondition(start + length <= size,
+                "read_npy(): file is too short.");
+            std::string dict(data + start, length);
+
+            npy_header res;
+            res.data_offset = start + length;
+
+            std::size_t pos = npy_find_key(dict, "descr");
+            std::size_t end = dict.find(dict[pos], pos + 1);
+            vigra_precondition(end != std::string::npos,
+                "read_npy(): malformed header.");
+            res.descr = dict.substr(pos + 1, end - pos - 1);
+            // single-byte types may be marked '|' or without byte order
+            if(res.descr.size() == 3 && res.descr[2] == '1')
+            {
+                res.descr[0] = '|';
+            }
+
+            pos = npy_find_key(dict, "fortran_order");
+            res.fortran_order = dict.compare(pos, 4, "True") == 0;
+
+            pos = npy_find_key(dict, "shape");
+            end = dict.find(')', pos);
+            vigra_precondition(dict[pos] == '(' && end != std::string::npos,
+                "read_npy(): malformed header.");
+            std::istringstream shape(dict.substr(pos + 1, end - pos - 1));
+            index_t s;
+            char comma;
+            while(shape >> s)
+            {
+                res.shape = res.shape.push_back(s);
+                shape >> comma;
+            }
+            return res;
+        }
+
+            // read the header of a .npy file, leaving 'in' at the start of the data
+        inline npy_header read_npy_header(std::istream & in)
+        {
+            std::string header(12, '\0');
+            in.read(&header[0], 12);
+            std::size_t start, length;
+            npy_dict_extent(header.data(), (std::size_t)in.gcount(), start, length);
+            header.resize(start + length);
+            in.clear();
+            in.seekg(start);
+            in.read(&header[start], length);
+            vigra_precondition(!!in,
+                "read_npy(): file is too short.");
+            return parse_npy_header(header.data(), header.size());
+        }
+
+        template <class T, index_t N>
+        void check_npy_header(npy_header const & header, std::string const & caller)
+        {
+            vigra_precondition(header.descr == npy_descr<T>(),
+                caller + "(): file has element type '" + header.descr +
+                "', but the array requires '" + npy_descr<T>() + "'.");
+            vigra_precondition(sizeof(T) == 1 || is_little_endian(),
+                caller + "(): only supported on little-endian machines.");
+            vigra_precondition(header.shape.size() > 0 &&
+                               (N == runtime_size || (index_t)header.shape.size() == N),
+                caller + "(): dimension mismatch between file and array.");
+        }
+
+        template <class T, index_t N>
+        void read_npy_data(std::istream & in, npy_header const & header,
+                           view_nd<T, N> const & out, std::string const & caller)
+        {
+            vigra_precondition(shape_t<>(out.shape()) == header.shape,
+                caller + "(): shape mismatch between file and array.");
+            if(header.fortran_order)
+            {
+                read_c_order(in, out.transpose(), caller);
+            }
+            else
+            {
+                read_c_order(in, out, caller);
+            }
+        }
+    } // namespace detail
+
+    /**
+     * Write an array in NumPy's .npy format (version 1.0).
+     * Arrays with arbitrary strides are supported, the file is always in C order.
+     */
+    template <class T, index_t N>
+    void write_npy(std::string filename, view_nd<T, N> const & data)
+    {
+        using value_type = std::remove_const_t<T>;
+        vigra_precondition(sizeof(T) == 1 || detail::is_little_endian(),
+            "write_npy(): only supported on little-endian machines.");
+        auto out = detail::open_output_file(filename, "write_npy");
+        std::string header = detail::npy_header_string(detail::npy_descr<value_type>(),
+                                                       shape_t<>(data.shape()));
+        out.write(header.data(), header.size());
+        detail::write_c_order(out, data, "write_npy");
+    }
+
+    /**
+     * Get the shape of the array stored in a .npy file.
+     */
+    inline shape_t<> read_npy_shape(std::string filename)
+    {
+        auto in = detail::open_input_file(filename, "read_npy_shape");
+        return detail::read_npy_header(in).shape;
+    }
+
+    /**
+     * Read a .npy file into a caller-provided array with arbitrary strides.
+     * The shape and element type of ``out`` must match the file.
+     */
+    template <class T, index_t N>
+    void read_npy_into(std::string filename, view_nd<T, N> out)
+    {
+        auto in = detail::open_input_file(filename, "read_npy_into");
+        auto header = detail::read_npy_header(in);
+        detail::check_npy_header<T, N>(header, "read_npy_into");
+        detail::read_npy_data(in, header, out, "read_npy_into");
+    }
+
+    /**
+     * Read a .npy file. The element type ``T`` must match the file
+     * (no conversion is performed).
+     */
+    template <class T, index_t N = runtime_size>
+    array_nd<T, N> read_npy(std::string filename)
+    {
+        auto in = detail::open_input_file(filename, "read_npy");
+        auto header = detail::read_npy_header(in);
+        detail::check_npy_header<T, N>(header, "read_npy");
+        array_nd<T, N> res(shape_t<N>(header.shape));
+        detail::read_npy_data(in, header, res, "read_npy");
+        return res;
+    }
+
+    /****************/
+    /* mapped_array */
+    /****************/
+
+        /** Memory-mapped array in a .npy file.
+
+            The array data are not copied into memory, but paged in by the operating
+            system on first access. This is the fastest way to access parts of a large
+            uncompressed file. The mapping is private: the view may be modified,
+            but changes are not written back to the file. The view is valid as long
+            as the mapped_array exists.
+        */
+    template <class T, index_t N = runtime_size>
+    class mapped_array
+    {
+      public:
+        using view_type = view_nd<T, N>;
+
+        explicit
+        mapped_array(std::string filename)
+        : file_(new detail::mapped_file(filename, "mapped_array"))
+        {
+            auto header = detail::parse_npy_header(file_->data(), file_->size());
+            detail::check_npy_header<T, N>(header, "mapped_array");
+            vigra_precondition(header.data_offset + prod(header.shape)*sizeof(T) <= file_->size(),
+                "mapped_array(): file is too short.");
+            char * data = file_->data() + header.data_offset;
+            vigra_precondition(reinterpret_cast<std::uintptr_t>(data) % alignof(T) == 0,
+                "mapped_array(): array data are not properly aligned.");
+            view_ = view_type(shape_t<N>(header.shape), reinterpret_cast<T *>(data),
+                              header.fortran_order ? f_order : c_order);
+        }
+
+        view_type const & view() const
+        {
+            return view_;
+        }
+
+        view_type & view()
+        {
+            return view_;
+        }
+
+      private:
+        std::unique_ptr<detail::mapped_file> file_;
+        view_type view_;
+    };
+
+    /******************/
+    /* chunked format */
+    /******************/
+
+    enum class chunk_compression { none = 0, zlib = 1 };
+
+        /** Options for 'write_chunked()'.
+        */
+    struct chunked_options
+    {
+        shape_t<> chunk_shape;              // default: 64 along each axis
+        chunk_compression compression = chunk_compression::none;
+        int level = 6;                      // zlib compression level (1...9)
+        index_t threads = 0;                // 0 means 'default_thread_count()'
+
+        chunked_options & chunks(shape_t<> const & s)
+        {
+            chunk_shape = s;
+            return *this;
+        }
+
+        chunked_options & compress(chunk_compression c, int l = 6)
+        {
+            compression = c;
+            level = l;
+            return *this;
+        }
+
+        chunked_options & thread_count(index_t n)
+        {
+            threads = n;
+            return *this;
+        }
+    };
+
+    namespace detail
+    {
+            /*
+                File layout of the chunked format (all integers are int64, little endian):
+
+                    char  magic[8]              "XVCHUNK1"
+                    char  descr[8]              element type as in .npy, padded with '\0'
+                    int64 ndim
+                    int64 compression           0: none, 1: zlib
+                    int64 shape[ndim]
+                    int64 chunk_shape[ndim]
+                    int64 index[2*chunk_count]  (file offset, stored size) of each chunk
+                    chunk data ...
+
+                Chunks are numbered in C order over the chunk grid. Chunks at the upper
+                border are clipped to the array shape.
+            */
+        struct chunked_layout
+        {
+            std::string descr;
+            chunk_compression compression;
+            shape_t<> shape, chunk_shape, grid_shape;
+
+            chunked_layout(std::string d, chunk_compression c, shape_t<> const & s, shape_t<> const & cs)
+            : descr(std::move(d))
+            , compression(c)
+            , shape(s)
+            , chunk_shape(cs)
+            , grid_shape((s + cs - 1) / cs)
+            {}
+
+            index_t chunk_count() const
+            {
+                return prod(grid_shape);
+            }
+
+            std::size_t header_size() const
+            {
+                return 8*(4 + 2*shape.size() + 2*chunk_count());
+            }
+
+                // ROI [begin, end) of chunk number 'i'
+            void chunk_roi(index_t i, shape_t<> & begin, shape_t<> & end) const
+            {
+                begin = shape_t<>(shape.size(), 0);
+                for(index_t k = (index_t)shape.size() - 1; k >= 0; --k)
+                {
+                    begin[k] = (i % grid_shape[k]) * chunk_shape[k];
+                    i /= grid_shape[k];
+                }
+                end = min(begin + chunk_shape, shape);
+            }
+        };
+
+        inline void write_int64(std::ostream & out, std::int64_t v)
+        {
+            out.write(reinterpret_cast<char const *>(&v), 8);
+        }
+
+        inline std::int64_t read_int64(char const * & p)
+        {
+            std::int64_t v;
+            std::memcpy(&v, p, 8);
+            p += 8;
+            return v;
+        }
+
+            // compress or copy 'size' bytes
+        inline std::vector<char> encode_chunk(char const * data, std::size_t size,
+                                              chunk_compression compression, int level)
+        {
+            if(compression == chunk_compression::none)
+            {
+                return std::vector<char>(data, data + size);
+            }
+#ifdef XVIGRA_USE_ZLIB
+            uLongf length = compressBound((uLong)size);
+            std::vector<char> res(length);
+            int status = compress2(reinterpret_cast<Bytef *>(res.data()), &length,
+                                   reinterpret_cast<Bytef const *>(data), (uLong)size, level);
+            vigra_precondition(status == Z_OK,
+                "write_chunked(): zlib compression failed.");
+            res.resize(length);
+            return res;
+#else
+            (void)level;
+            vigra_fail("write_chunked(): zlib compression requires XVIGRA_USE_ZLIB.");
+            return std::vector<char>();
+#endif
+        }
+
+            // decompress or copy a chunk into 'dest' which can hold 'size' bytes
+        inline void decode_chunk(char const * data, std::size_t stored_size,
+                                 char * dest, std::size_t size,
+                                 chunk_compression compression)
+        {
+            if(compression == chunk_compression::none)
+            {
+                vigra_precondition(stored_size == size,
+                    "read_chunked(): corrupted chunk.");
+                std::memcpy(dest, data, size);
+                return;
+            }
+#ifdef XVIGRA_USE_ZLIB
+            uLongf length = (uLongf)size;
+            int status = uncompress(reinterpret_cast<Bytef *>(dest), &length,
+                                    reinterpret_cast<Bytef const *>(data), (uLong)stored_size);
+            vigra_precondition(status == Z_OK && length == size,
+                "read_chunked(): corrupted chunk.");
+#else
+            (void)data; (void)stored_size; (void)dest;
+            vigra_fail("read_chunked(): zlib decompression requires XVIGRA_USE_ZLIB.");
+#endif
+        }
+
+        inline chunked_layout parse_chunked_header(mapped_file const & file, std::vector<std::int64_t> & index)
+        {
+            char const * p = file.data();
+            vigra_precondition(file.size() >= 32 && std::string(p, 8) == "XVCHUNK1",
+                "read_chunked(): not a chunked array file.");
+            vigra_precondition(is_little_endian(),
+                "read_chunked(): only supported on little-endian machines.");
+            std::string descr(std::string(p + 8, 8).c_str());
+            p += 16;
+            index_t ndim = read_int64(p);
+            std::int64_t compression = read_int64(p);
+            vigra_precondition(ndim > 0 && file.size() >= 32 + 16*(std::size_t)ndim && compression >= 0 && compression <= 1,
+                "read_chunked(): corrupted header.");
+            shape_t<> shape(ndim, dont_init), chunk_shape(ndim, dont_init);
+            for(auto & s: shape)
+                s = read_int64(p);
+            for(auto & s: chunk_shape)
+                s = read_int64(p);
+            vigra_precondition(min(chunk_shape) > 0 && min(shape) >= 0,
+                "read_chunked(): corrupted header.");
+            chunked_layout layout(descr, (chunk_compression)compression, shape, chunk_shape);
+            vigra_precondition(file.size() >= layout.header_size(),
+                "read_chunked(): file is too short.");
+            index.resize(2*layout.chunk_count());
+            for(auto & i: index)
+                i = read_int64(p);
+            return layout;
+        }
+    } // namespace detail
+
+    /**
+     * Write an array in xvigra's chunked format.
+     *
+     * The array is split into blocks of ``options.chunk_shape`` which are
+     * optionally compressed with zlib (requires XVIGRA_USE_ZLIB, i.e. the CMake
+     * option USE_ZLIB). Chunks are encoded in parallel and written in batches,
+     * so the memory overhead is bounded by a few chunks per thread.
+     */
+    template <class T, index_t N>
+    void write_chunked(std::string filename, view_nd<T, N> const & data,
+                       chunked_options const & options = chunked_options())
+    {
+        using value_type = std::remove_const_t<T>;
+        vigra_precondition(detail::is_little_endian(),
+            "write_chunked(): only supported on little-endian machines.");
+        vigra_precondition(data.dimension() > 0,
+            "write_chunked(): array must have at least one dimension.");
+        shape_t<> shape(data.shape()),
+                  chunk_shape = options.chunk_shape.size() == 0
+                                   ? min(shape, shape_t<>(shape.size(), 64))
+                                   : options.chunk_shape;
+        vigra_precondition(chunk_shape.size() == shape.size() && min(chunk_shape) > 0,
+            "write_chunked(): invalid chunk shape.");
+        detail::chunked_layout layout(detail::npy_descr<value_type>(), options.compression,
+                                      shape, chunk_shape);
+
+        auto out = detail::open_output_file(filename, "write_chunked");
+        std::string descr = layout.descr;
+        descr.resize(8, '\0');
+        out.write("XVCHUNK1", 8);
+        out.write(descr.data(), 8);
+        detail::write_int64(out, shape.size());
+        detail::write_int64(out, (std::int64_t)options.compression);
+        for(auto s: shape)
+            detail::write_int64(out, s);
+        for(auto s: chunk_shape)
+            detail::write_int64(out, s);
+
+        index_t chunk_count = layout.chunk_count(),
+                threads = options.threads <= 0 ? default_thread_count() : options.threads,
+                batch_size = 4*threads;
+        std::vector<std::int64_t> index(2*chunk_count, 0);
+        std::streamoff index_pos = out.tellp();
+        out.seekp(index_pos + 16*chunk_count);
+
+        std::vector<std::vector<char>> batch(batch_size);
+        for(index_t b = 0; b < chunk_count; b += batch_size)
+        {
+            index_t current = std::min(batch_size, chunk_count - b);
+            parallel_for(current,
+                [&](index_t begin, index_t end)
+                {
+                    shape_t<> p, q;
+                    std::vector<value_type> buffer;
+                    for(index_t i = begin; i < end; ++i)
+                    {
+                        layout.chunk_roi(b + i, p, q);
+                        buffer.resize(prod(q - p));
+                        view_nd<value_type, N> chunk(shape_t<N>(q - p), buffer.data());
+                        chunk = data.subarray(shape_t<N>(p), shape_t<N>(q));
+                        batch[i] = detail::encode_chunk(reinterpret_cast<char const *>(buffer.data()),
+                                                        buffer.size()*sizeof(T),
+                                                        options.compression, options.level);
+                    }
+                },
+                threads, 1);
+            for(index_t i = 0; i < current; ++i)
+            {
+                index[2*(b + i)]     = out.tellp();
+                index[2*(b + i) + 1] = batch[i].size();
+                out.write(batch[i].data(), batch[i].size());
+                std::vector<char>().swap(batch[i]);
+            }
+        }
+        out.seekp(index_pos);
+        for(auto i: index)
+            detail::write_int64(out, i);
+        vigra_precondition(!!out, "write_chunked(): write error.");
+    }
+
+    /**
+     * Get the shape of the array stored in a chunked file.
+     */
+    inline shape_t<> read_chunked_shape(std::string filename)
+    {
+        detail::mapped_file file(filename, "read_chunked_shape");
+        std::vector<std::int64_t> index;
+        return detail::parse_chunked_header(file, index).shape;
+    }
+
+    /**
+     * Read a chunked file into a caller-provided array with arbitrary strides.
+     *
+     * The file is memory-mapped, so uncompressed chunks are copied directly from the
+     * page cache into ``out``. Chunks are decoded in parallel by up to ``thread_count``
+     * threads (<tt>thread_count <= 0</tt> means 'default_thread_count()').
+     */
+    template <class T, index_t N>
+    void read_chunked_into(std::string filename, view_nd<T, N> out, index_t thread_count = 0)
+    {
+        detail::mapped_file file(filename, "read_chunked_into");
+        std::vector<std::int64_t> index;
+        auto layout = detail::parse_chunked_header(file, index);
+        vigra_precondition(layout.descr == detail::npy_descr<T>(),
+            "read_chunked_into(): file has element type '" + layout.descr +
+            "', but the array requires '" + detail::npy_descr<T>() + "'.");
+        vigra_precondition(shape_t<>(out.shape()) == layout.shape,
+            "read_chunked_into(): shape mismatch between file and array.");
+
+        parallel_for(layout.chunk_count(),
+            [&](index_t begin, index_t end)
+            {
+                shape_t<> p, q;
+                std::vector<T> buffer;
+                for(index_t i = begin; i < end; ++i)
+                {
+                    layout.chunk_roi(i, p, q);
+                    std::int64_t offset = index[2*i], stored_size = index[2*i+1];
+                    vigra_precondition(offset >= 0 && stored_size >= 0 &&
+                                       (std::size_t)(offset + stored_size) <= file.size(),
+                        "read_chunked_into(): corrupted chunk index.");
+                    char const * data = file.data() + offset;
+                    index_t size = prod(q - p);
+                    view_nd<T, N> target = out.subarray(shape_t<N>(p), shape_t<N>(q));
+                    if(layout.compression == chunk_compression::none &&
+                       reinterpret_cast<std::uintptr_t>(data) % alignof(T) == 0)
+                    {
+                        vigra_precondition(stored_size == size*(std::int64_t)sizeof(T),
+                            "read_chunked_into(): corrupted chunk.");
+                        target = view_nd<T, N>(shape_t<N>(q - p), reinterpret_cast<T const *>(data));
+                    }
+                    else
+                    {
+                        buffer.resize(size);
+                        detail::decode_chunk(data, stored_size, reinterpret_cast<char *>(buffer.data()),
+                                             size*sizeof(T), layout.compression);
+                        target = view_nd<T, N>(shape_t<N>(q - p), buffer.data());
+                    }
+                }
+            },
+            thread_count);
+    }
+
+    /**
+     * Read a chunked file. The element type ``T`` must match the file.
+     */
+    template <class T, index_t N = runtime_size>
+    array_nd<T, N> read_chunked(std::string filename, index_t thread_count = 0)
+    {
+        array_nd<T, N> res(shape_t<N>(read_chunked_shape(filename)));
+        read_chunked_into(filename, res, thread_count);
+        return res;
+    }
+
+} // namespace xvigra
+
+#endif // XVIGRA_ARRAY_IO_HPP
@@ -323,6 +323,229 @@ namespace xvigra
         };
     }
 
+    /***********************/
+    /* hyperplane_iterator */
+    /***********************/
+
+        /** Iterate over all M-dimensional hyperplanes of an array that are
+            spanned by the given 'free' axes.
+
+            This is a lightweight alternative to 'slicer' when the hyperplanes
+            are needed in an inner loop (e.g. 1D convolution or distance
+            transforms along a given axis): the iterator only keeps a coordinate
+            and a pointer offset for the remaining axes, so that advancing to
+            the next hyperplane is amortized O(1) and doesn't allocate. The
+            hyperplanes are visited in the order given by the 'order' argument
+            (with <tt>c_order</tt>, the last non-free axis varies fastest).
+
+            The iterator is also random-access: 'operator[](i)' and 'offset(i)'
+            refer to the i-th hyperplane, 'set_index(i)' jumps there, and
+            'subrange(begin, end)' returns an iterator restricted to the hyperplanes
+            [begin, end). This allows to split the iteration into independent
+            chunks, e.g. for multi-threading (see 'parallel_for_lines()').
+
+            Usage:
+            \code
+            array_nd<float, 3> a(...);
+            for(auto line = a.lines(1); line.has_more(); ++line)
+            {
+                view_nd<float, 1> v = *line;  // or use line.data(), line.stride(), line.length()
+                ...
+            }
+            \endcode
+        */
+    template <class T, index_t M>
+    class hyperplane_iterator
+    {
+      public:
+        static_assert(M != 0,
+            "hyperplane_iterator: hyperplanes must have at least one dimension.");
+
+        using value_type = T;
+        using pointer    = T *;
+        using view_type  = view_nd<T, M>;
+        using shape_type = typename view_type::shape_type;
+
+        hyperplane_iterator()
+        : data_(0)
+        , offset_(0)
+        , index_(0)
+        , end_(0)
+        , size_(0)
+        {}
+
+        template <index_t N>
+        hyperplane_iterator(shape_t<N> const & shape,
+                            shape_t<N> const & strides,
+                            pointer data,
+                            shape_t<M> const & free_axes,
+                            tags::memory_order order = c_order)
+        : data_(data)
+        , offset_(0)
+        , index_(0)
+        , end_(0)
+        , size_(1)
+        , free_shape_(free_axes.size(), dont_init)
+        , free_strides_(free_axes.size(), dont_init)
+        {
+            index_t ndim = shape.size(),
+                    nfree = free_axes.size();
+            vigra_precondition(0 < nfree && nfree <= ndim,
+                "hyperplane_iterator(): number of free axes must be in [1, dimension()].");
+
+            shape_t<M> axes(free_axes);
+            std::sort(axes.begin(), axes.end());
+            for(index_t k=0; k<nfree; ++k)
+            {
+                vigra_precondition(0 <= axes[k] && axes[k] < ndim && (k == 0 || axes[k-1] < axes[k]),
+                    "hyperplane_iterator(): free axes must be unique and in [0, dimension()).");
+                free_shape_[k]   = shape[axes[k]];
+                free_strides_[k] = strides[axes[k]];
+            }
+
+            // the remaining axes are iterated over, fastest axis first
+            shape_t<> iter_axes = shape_t<>::range(ndim);
+            for(index_t k=nfree-1; k>=0; --k)
+            {
+                iter_axes = iter_axes.erase(axes[k]);
+            }
+            if(order == c_order)
+            {
+                iter_axes = reversed(iter_axes);
+            }
+            index_t niter = iter_axes.size();
+            point_        = shape_t<>(niter, 0);
+            iter_shape_   = shape_t<>(niter, dont_init);
+            iter_strides_ = shape_t<>(niter, dont_init);
+            for(index_t k=0; k<niter; ++k)
+            {
+                iter_shape_[k]   = shape[iter_axes[k]];
+                iter_strides_[k] = strides[iter_axes[k]];
+                size_ *= iter_shape_[k];
+            }
+            end_ = size_;
+        }
+
+        bool has_more() const
+        {
+            return index_ < end_;
+        }
+
+        void operator++()
+        {
+            ++index_;
+            for(index_t k=0; k<point_.size(); ++k)
+            {
+                offset_ += iter_strides_[k];
+                if(++point_[k] < iter_shape_[k])
+                    return;
+                offset_ -= iter_shape_[k]*iter_strides_[k];
+                point_[k] = 0;
+            }
+        }
+
+            // view of the current hyperplane
+        view_type operator*() const
+        {
+            return view_type(free_shape_, free_strides_, data());
+        }
+
+            // pointer to the first element of the current hyperplane
+        pointer data() const
+        {
+            return data_ + offset_;
+        }
+
+            // shape and strides of the hyperplanes
+        shape_type const & shape() const
+        {
+            return free_shape_;
+        }
+
+        shape_type const & strides() const
+        {
+            return free_strides_;
+        }
+
+            // convenience functions for line iterators (M == 1)
+        index_t length() const
+        {
+            return free_shape_[0];
+        }
+
+        index_t stride() const
+        {
+            return free_strides_[0];
+        }
+
+            // total number of hyperplanes
+        index_t size() const
+        {
+            return size_;
+        }
+
+            // running index of the current hyperplane
+        index_t index() const
+        {
+            return index_;
+        }
+
+            // memory offset of the i-th hyperplane relative to the array's origin
+        index_t offset(index_t i) const
+        {
+            index_t res = 0;
+            for(index_t k=0; k<iter_shape_.size(); ++k)
+            {
+                res += (i % iter_shape_[k])*iter_strides_[k];
+                i /= iter_shape_[k];
+            }
+            return res;
+        }
+
+            // view of the i-th hyperplane
+        view_type operator[](index_t i) const
+        {
+            return view_type(free_shape_, free_strides_, data_ + offset(i));
+        }
+
+            // move to the i-th hyperplane
+        void set_index(index_t i)
+        {
+            vigra_precondition(0 <= i && i <= size_,
+                "hyperplane_iterator::set_index(): index out of range.");
+            index_  = i;
+            offset_ = 0;
+            for(index_t k=0; k<point_.size() && size_ > 0; ++k)
+            {
+                point_[k] = i % iter_shape_[k];
+                offset_  += point_[k]*iter_strides_[k];
+                i /= iter_shape_[k];
+            }
+        }
+
+            // iterator over the hyperplanes [begin, end)
+        hyperplane_iterator subrange(index_t begin, index_t end) const
+        {
+            vigra_precondition(0 <= begin && begin <= end && end <= size_,
+                "hyperplane_iterator::subrange(): invalid range.");
+            hyperplane_iterator res(*this);
+            res.set_index(begin);
+            res.end_ = end;
+            return res;
+        }
+
+      private:
+        pointer    data_;
+        index_t    offset_, index_, end_, size_;
+        shape_type free_shape_, free_strides_;
+        shape_t<>  point_, iter_shape_, iter_strides_;
+    };
+
+        /** Iterate over all 1D lines of an array along a given axis.
+        */
+    template <class T>
+    using line_iterator = hyperplane_iterator<T, 1>;
+
     /***********/
     /* view_nd */
     /***********/
@@ -1382,6 +1605,34 @@ namespace xvigra
             return const_cast<self_type *>(this)->view(s);
         }
 
+            // iterate over all 1D lines along the given axis
+        line_iterator<T>
+        lines(index_t axis, tags::memory_order order = c_order)
+        {
+            return line_iterator<T>(shape_, strides_, raw_data(), shape_t<1>{axis}, order);
+        }
+
+        line_iterator<const_value_type>
+        lines(index_t axis, tags::memory_order order = c_order) const
+        {
+            return line_iterator<const_value_type>(shape_, strides_, raw_data(), shape_t<1>{axis}, order);
+        }
+
+            // iterate over all hyperplanes spanned by the given axes
+        template <index_t M>
+        hyperplane_iterator<T, M>
+        hyperplanes(shape_t<M> const & free_axes, tags::memory_order order = c_order)
+        {
+            return hyperplane_iterator<T, M>(shape_, strides_, raw_data(), free_axes, order);
+        }
+
+        template <index_t M>
+        hyperplane_iterator<const_value_type, M>
+        hyperplanes(shape_t<M> const & free_axes, tags::memory_order order = c_order) const
+        {
+            return hyperplane_iterator<const_value_type, M>(shape_, strides_, raw_data(), free_axes, order);
+        }
+
         // pointer data()
         // {
         //     return (pointer)data_;
@@ -1670,6 +1921,10 @@ namespace xvigra
     /* array_nd */
     /************/
 
+        // byte alignment of the rows of arrays created with 'aligned_rows'
+        // (sufficient for aligned SIMD loads up to AVX-512)
+    constexpr index_t aligned_row_bytes = 64;
+
     template <class T, index_t N, class ALLOC>
     class array_nd
     : public view_nd<T, N>
@@ -1760,14 +2015,66 @@ namespace xvigra
             this->data_  = &allocated_data_[0];
             this->flags_ |= this->contiguous_memory_flag | this->owns_memory_flag;
         }
+
+            /** construct with given shape, such that every row starts at an
+                'aligned_row_bytes' boundary:
+
+                \code
+                array_nd<float, 2> a({480, 641}, aligned_rows);  // a.strides() == {656, 1}
+                \endcode
+
+                The row pitch (i.e. the stride of the second-to-last axis) is
+                rounded up accordingly, but the array reports its logical shape.
+                The rows are not padded if sizeof(T) doesn't divide 'aligned_row_bytes'.
+             */
+        array_nd(shape_type const & shape,
+                 tags::aligned_rows_tag,
+                 const_reference init = value_type(),
+                 allocator_type const & alloc = allocator_type())
+        : view_type()
+        , allocated_data_(alloc)
+        {
+            vigra_precondition(all_greater_equal(shape, 0),
+                "array_nd(): invalid shape.");
+            index_t align = (aligned_row_bytes % sizeof(raw_value_type) == 0)
+                                ? aligned_row_bytes / sizeof(raw_value_type)
+                                : 1;
+            shape_type strides(shape);
+            index_t size = 1;
+            for(index_t k=(index_t)shape.size()-1; k>=0; --k)
+            {
+                strides[k] = size;
+                size *= shape[k];
+                if(k == (index_t)shape.size()-1)
+                {
+                    size = (size + align - 1) / align * align;
+                }
+            }
+            allocated_data_.resize(size + align, init);
+            view_type::operator=(view_type(shape, strides, aligned_data_start(allocated_data_)));
+            this->flags_ |= this->owns_memory_flag;
+        }
+
            /** copy constructor
              */
         array_nd(array_nd const & rhs)
         : view_type(rhs)
         , allocated_data_(rhs.allocated_data_)
         {
-            this->data_  = &allocated_data_[0];
-            this->flags_ |= this->contiguous_memory_flag | this->owns_memory_flag;
+            if(!rhs.has_data() || rhs.size() == 0 ||
+               (rhs.is_contiguous() && rhs.raw_data() == &rhs.allocated_data_[0]))
+            {
+                this->data_  = &allocated_data_[0];
+                this->flags_ |= this->contiguous_memory_flag | this->owns_memory_flag;
+            }
+            else
+            {
+                // aligned rows (padded row pitch and/or data offset): keep the
+                // layout, but realign w.r.t. the new buffer
+                this->data_ = aligned_data_start(allocated_data_);
+                std::copy(rhs.raw_data(), &rhs[rhs.shape()-1] + 1, this->data_);
+                this->flags_ |= this->owns_memory_flag;
+            }
         }
 
             /** move constructor
@@ -1992,7 +2299,7 @@ namespace xvigra
             {
                 new_axistags = axistags_type(new_shape.size(), tags::axis_unknown);
             }
-            if(this->size() == xt::compute_size(new_shape))
+            if(this->size() == xt::compute_size(new_shape) && this->is_contiguous())
             {
                 this->reshape(new_shape, new_axistags, order);
            }
@@ -2021,6 +2328,24 @@ namespace xvigra
         {
             return allocated_data_.get_allocator();
         }
+
+      private:
+
+            // first element in 'data' at an 'aligned_row_bytes' boundary (if possible)
+        static pointer aligned_data_start(buffer_type & data)
+        {
+            if(aligned_row_bytes % sizeof(raw_value_type) != 0)
+            {
+                return &data[0];
+            }
+            std::size_t misalignment = (std::size_t)&data[0] % aligned_row_bytes,
+                        offset = misalignment == 0
+                                     ? 0
+                                     : aligned_row_bytes - misalignment;
+            return offset % sizeof(raw_value_type) == 0
+                       ? &data[0] + offset / sizeof(raw_value_type)
+                       : &data[0];
+        }
     };
 
     template <class T, index_t N, class A>
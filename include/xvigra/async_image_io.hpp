@@ -0,0 +1,327 @@
+/************************************************************************/
+/*                                                                      */
+/*     Copyright 2017-2018 by Ullrich Koethe                            */
+/*                                                                      */
+/*    This file is part of the XVIGRA image analysis library.           */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+
+#ifndef XVIGRA_ASYNC_IMAGE_IO_HPP
+#define XVIGRA_ASYNC_IMAGE_IO_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "global.hpp"
+#include "error.hpp"
+#include "array_nd.hpp"
+#include "image_io.hpp"
+
+namespace xvigra
+{
+    /****************/
+    /* image_loader */
+    /****************/
+
+        /** Load a sequence of images in the background.
+
+            Up to 'prefetch' files are read concurrently on background threads
+            while the caller processes the current image, so that I/O overlaps
+            computation:
+
+            \code
+            image_loader<float> loader(filenames, 4);
+            while(loader.has_more())
+            {
+                std::string filename = loader.filename();
+                array_nd<float> image = loader.next();
+                ... // process 'image'
+                loader.recycle(std::move(image));
+            }
+            \endcode
+
+            Arrays passed to 'recycle()' are kept in a pool and reused for
+            subsequent files of the same shape, which avoids repeated allocation
+            when a stack of equally sized images is processed. Errors during
+            loading are rethrown by 'next()'.
+        */
+    template <class T = float>
+    class image_loader
+    {
+      public:
+        using array_type = array_nd<T>;
+
+        explicit
+        image_loader(std::vector<std::string> filenames, index_t prefetch = 2)
+        : filenames_(std::move(filenames))
+        , next_(0)
+        , requested_(0)
+        , prefetch_(std::max<index_t>(1, prefetch))
+        {
+            request_more();
+        }
+
+        ~image_loader()
+        {
+            // wait for pending loads before the pool is destroyed
+            for(auto & f: pending_)
+            {
+                if(f.valid())
+                    f.wait();
+            }
+        }
+
+        image_loader(image_loader const &) = delete;
+        image_loader & operator=(image_loader const &) = delete;
+
+            // true while not all files have been returned by 'next()'
+        bool has_more() const
+        {
+            return next_ < (index_t)filenames_.size();
+        }
+
+            // index of the file returned by the next call to 'next()'
+        index_t index() const
+        {
+            return next_;
+        }
+
+            // name of the file returned by the next call to 'next()'
+        std::string const & filename() const
+        {
+            return filenames_[next_];
+        }
+
+            // get the next image (blocks until it has been loaded)
+        array_type next()
+        {
+            vigra_precondition(has_more(),
+                "image_loader::next(): no more files.");
+            std::future<array_type> f = std::move(pending_.front());
+            pending_.pop_front();
+            ++next_;
+            request_more();
+            return f.get();
+        }
+
+            // return an array to the buffer pool for reuse
+        void recycle(array_type && a)
+        {
+            std::lock_guard<std::mutex> guard(pool_lock_);
+            pool_.push_back(std::move(a));
+        }
+
+      private:
+
+        void request_more()
+        {
+            while(requested_ < (index_t)filenames_.size() && requested_ < next_ + prefetch_)
+            {
+                pending_.push_back(std::async(std::launch::async,
+                                              &image_loader::load, this, filenames_[requested_]));
+                ++requested_;
+            }
+        }
+
+        array_type load(std::string filename)
+        {
+            auto in = detail::open_image_input(filename, "image_loader");
+            array_type image = get_buffer(image_info(in->spec()).shape());
+            detail::read_subimage_into(*in, image, 0, "image_loader");
+            return image;
+        }
+
+        array_type get_buffer(shape_t<> const & shape)
+        {
+            {
+                std::lock_guard<std::mutex> guard(pool_lock_);
+                for(auto k = pool_.begin(); k != pool_.end(); ++k)
+                {
+                    if(k->shape() == shape)
+                    {
+                        array_type res(std::move(*k));
+                        pool_.erase(k);
+                        return res;
+                    }
+                }
+            }
+            return array_type(shape);
+        }
+
+        std::vector<std::string> filenames_;
+        index_t next_, requested_, prefetch_;
+        std::deque<std::future<array_type>> pending_;
+        std::vector<array_type> pool_;
+        std::mutex pool_lock_;
+    };
+
+    /****************/
+    /* image_writer */
+    /****************/
+
+        /** Save images on a background thread.
+
+            'push()' takes ownership of an array and returns immediately unless
+            'max_pending' images are already waiting to be written, in which case
+            it blocks until the queue has room (this bounds the memory held by the
+            queue). 'wait()' blocks until all queued images have been written and
+            rethrows the first error that occurred while writing. The destructor
+            writes all remaining images.
+
+            \code
+            image_writer writer;
+            for(...)
+            {
+                array_nd<float> result = ...;
+                writer.push("result_" + std::to_string(k) + ".tif", std::move(result));
+            }
+            writer.wait();
+            \endcode
+        */
+    class image_writer
+    {
+      public:
+
+        explicit
+        image_writer(index_t max_pending = 4)
+        : max_pending_(std::max<index_t>(1, max_pending))
+        , busy_(false)
+        , stop_(false)
+        , thread_(&image_writer::run, this)
+        {}
+
+        ~image_writer()
+        {
+            {
+                std::lock_guard<std::mutex> guard(lock_);
+                stop_ = true;
+            }
+            not_empty_.notify_one();
+            thread_.join();
+        }
+
+        image_writer(image_writer const &) = delete;
+        image_writer & operator=(image_writer const &) = delete;
+
+            // enqueue 'image' for writing (pass an rvalue to avoid a copy)
+        template <class T, index_t N>
+        void push(std::string filename, array_nd<T, N> image,
+                  write_image_options const & options = write_image_options())
+        {
+            auto image_ptr = std::make_shared<array_nd<T, N>>(std::move(image));
+            enqueue([filename, image_ptr, options]()
+                    {
+                        write_image(filename, *image_ptr, options);
+                    });
+        }
+
+            // enqueue a copy of 'image'
+        template <class T, index_t N>
+        void push(std::string filename, view_nd<T, N> const & image,
+                  write_image_options const & options = write_image_options())
+        {
+            push(std::move(filename), array_nd<std::remove_const_t<T>, N>(image), options);
+        }
+
+            // block until all queued images have been written
+        void wait()
+        {
+            std::unique_lock<std::mutex> guard(lock_);
+            not_full_.wait(guard, [this]() { return queue_.empty() && !busy_; });
+            if(error_)
+            {
+                std::exception_ptr e = error_;
+                error_ = nullptr;
+                std::rethrow_exception(e);
+            }
+        }
+
+        index_t pending() const
+        {
+            std::lock_guard<std::mutex> guard(lock_);
+            return (index_t)queue_.size() + (busy_ ? 1 : 0);
+        }
+
+      private:
+
+        void enqueue(std::function<void()> task)
+        {
+            {
+                std::unique_lock<std::mutex> guard(lock_);
+                not_full_.wait(guard, [this]() { return (index_t)queue_.size() < max_pending_; });
+                queue_.push_back(std::move(task));
+            }
+            not_empty_.notify_one();
+        }
+
+        void run()
+        {
+            std::unique_lock<std::mutex> guard(lock_);
+            while(true)
+            {
+                not_empty_.wait(guard, [this]() { return stop_ || !queue_.empty(); });
+                if(queue_.empty())
+                    return; // 'stop_' is set and all images have been written
+                std::function<void()> task = std::move(queue_.front());
+                queue_.pop_front();
+                busy_ = true;
+                guard.unlock();
+                not_full_.notify_all();
+                try
+                {
+                    task();
+                }
+                catch(...)
+                {
+                    std::lock_guard<std::mutex> error_guard(lock_);
+                    if(!error_)
+                        error_ = std::current_exception();
+                }
+                guard.lock();
+                busy_ = false;
+                not_full_.notify_all();
+            }
+        }
+
+        index_t max_pending_;
+        bool busy_, stop_;
+        std::deque<std::function<void()>> queue_;
+        std::exception_ptr error_;
+        mutable std::mutex lock_;
+        std::condition_variable not_empty_, not_full_;
+        std::thread thread_;
+    };
+
+} // namespace xvigra
+
+#endif // XVIGRA_ASYNC_IMAGE_IO_HPP
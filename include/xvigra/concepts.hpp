@@ -168,6 +168,15 @@ namespace xvigra
     : public std::is_base_of<tags::view_nd_tag, std::decay_t<T>>
     {};
 
+    /**************************/
+    /* planar_view_nd_concept */
+    /**************************/
+
+    template <class T>
+    struct planar_view_nd_concept
+    : public std::is_base_of<tags::planar_view_nd_tag, std::decay_t<T>>
+    {};
+
     /*********************/
     /* kernel_1d_concept */
     /*********************/
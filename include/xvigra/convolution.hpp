@@ -0,0 +1,767 @@
+/************************************************************************/
+/*                                                                      */
+/*     Copyright 2017-2018 by Ullrich Koethe                            */
+/*                                                                      */
+/*    This file is part of the XVIGRA image analysis library.           */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+
+#ifndef XVIGRA_CONVOLUTION_HPP
+#define XVIGRA_CONVOLUTION_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <utility>
+#include <vector>
+#include "global.hpp"
+#include "error.hpp"
+#include "array_nd.hpp"
+#include "fft.hpp"
+#include "functor_base.hpp"
+#include "kernel.hpp"
+#include "padding.hpp"
+#include "separable_convolution.hpp"
+
+namespace xvigra
+{
+    /************************/
+    /* separable_kernel_sum */
+    /************************/
+
+    namespace detail
+    {
+            // Decompose a 'rows x cols' matrix (in row-major order) into a sum of
+            // rank-1 terms 'column * row^T' by a one-sided Jacobi SVD. The terms are
+            // ordered by decreasing singular value, which is merged into the column
+            // vector. Only as many terms are returned as needed to approximate the
+            // matrix up to the relative Frobenius norm error 'tolerance'.
+        inline std::vector<std::pair<std::vector<double>, std::vector<double>>>
+        separable_kernel_sum(std::vector<double> const & matrix, index_t rows, index_t cols,
+                             double tolerance)
+        {
+            // 'a' holds the columns of the matrix, 'v' accumulates the rotations
+            std::vector<std::vector<double>> a(cols, std::vector<double>(rows)),
+                                             v(cols, std::vector<double>(cols, 0.0));
+            for(index_t j=0; j<cols; ++j)
+            {
+                for(index_t i=0; i<rows; ++i)
+                {
+                    a[j][i] = matrix[i*cols+j];
+                }
+                v[j][j] = 1.0;
+            }
+
+            for(int sweep=0; sweep<50; ++sweep)
+            {
+                bool rotated = false;
+                for(index_t p=0; p<cols-1; ++p)
+                {
+                    for(index_t q=p+1; q<cols; ++q)
+                    {
+                        double alpha = 0.0, beta = 0.0, gamma = 0.0;
+                        for(index_t i=0; i<rows; ++i)
+                        {
+                            alpha += a[p][i]*a[p][i];
+                            beta  += a[q][i]*a[q][i];
+                            gamma += a[p][i]*a[q][i];
+                        }
+                        if(std::abs(gamma) <= 1e-15*std::sqrt(alpha*beta))
+                        {
+                            continue;
+                        }
+                        rotated = true;
+                        double zeta = (beta - alpha) / (2.0*gamma),
+                               t    = (zeta >= 0.0 ? 1.0 : -1.0) / (std::abs(zeta) + std::sqrt(1.0 + zeta*zeta)),
+                               c    = 1.0 / std::sqrt(1.0 + t*t),
+                               s    = c*t;
+                        for(index_t i=0; i<rows; ++i)
+                        {
+                            double ap = a[p][i], aq = a[q][i];
+                            a[p][i] = c*ap - s*aq;
+                            a[q][i] = s*ap + c*aq;
+                        }
+                        for(index_t i=0; i<cols; ++i)
+                        {
+                            double vp = v[p][i], vq = v[q][i];
+                            v[p][i] = c*vp - s*vq;
+                            v[q][i] = s*vp + c*vq;
+                        }
+                    }
+                }
+                if(!rotated)
+                {
+                    break;
+                }
+            }
+
+            // the norms of the rotated columns are the singular values
+            std::vector<std::pair<double, index_t>> sigma(cols);
+            double total = 0.0;
+            for(index_t j=0; j<cols; ++j)
+            {
+                double s2 = 0.0;
+                for(index_t i=0; i<rows; ++i)
+                {
+                    s2 += a[j][i]*a[j][i];
+                }
+                sigma[j] = std::make_pair(s2, j);
+                total += s2;
+            }
+            std::sort(sigma.begin(), sigma.end(),
+                      [](std::pair<double, index_t> const & l, std::pair<double, index_t> const & r)
+                      {
+                          return l.first > r.first;
+                      });
+
+            std::vector<std::pair<std::vector<double>, std::vector<double>>> res;
+            double residual = total;
+            for(index_t k=0; k<cols; ++k)
+            {
+                if(residual <= tolerance*tolerance*total)
+                {
+                    break;
+                }
+                residual -= sigma[k].first;
+                index_t j = sigma[k].second;
+                res.emplace_back(a[j], v[j]);
+            }
+            return res;
+        }
+
+            // width of the output row tiles of the direct convolution: all kernel
+            // taps are accumulated into a tile while it is still in L1 cache
+        constexpr index_t convolution_tile_width = 1024;
+
+            // Determine the borders required by a kernel of size 'ksize' with the
+            // given 'center', the padding actually added to the input, and the region
+            // [begin, end) of output points to be computed (with 'no_padding', only the
+            // points where the kernel fits completely into the input). Returns false
+            // if this region is empty.
+        template <class SHAPE>
+        inline bool convolution_region(SHAPE const & shape, SHAPE const & ksize, SHAPE const & center,
+                                       convolution_options const & options,
+                                       SHAPE & left, SHAPE & pad_left, SHAPE & pad_right,
+                                       SHAPE & begin, SHAPE & end)
+        {
+            index_t N = shape.size();
+            left = ksize - center - 1;
+            pad_left = SHAPE(N, 0);
+            pad_right = SHAPE(N, 0);
+            begin = SHAPE(N, 0);
+            end = shape;
+            for(index_t d=0; d<N; ++d)
+            {
+                if(options.get_left_padding(d) == no_padding)
+                {
+                    begin[d] = left[d];
+                }
+                else
+                {
+                    pad_left[d] = left[d];
+                }
+                if(options.get_right_padding(d) == no_padding)
+                {
+                    end[d] = shape[d] - center[d];
+                }
+                else
+                {
+                    pad_right[d] = center[d];
+                }
+                if(begin[d] >= end[d])
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+            // copy 'in' into the interior of a temporary with aligned rows
+            // and fill the borders according to the padding modes
+        template <class T, class T1, index_t N1>
+        array_nd<T, N1> padded_temporary(view_nd<T1, N1> const & in,
+                                         shape_t<N1> const & pad_left, shape_t<N1> const & pad_right,
+                                         convolution_options const & options)
+        {
+            XVIGRA_TRACE_SCOPE("padding", "stage");
+            index_t N = in.dimension();
+            tiny_vector<padding_mode> left_modes(N), right_modes(N);
+            for(index_t d=0; d<N; ++d)
+            {
+                left_modes[d]  = options.get_left_padding(d);
+                right_modes[d] = options.get_right_padding(d);
+            }
+            auto padded = allocate_aligned_temporary<T>(shape_t<N1>(in.shape() + pad_left + pad_right));
+            pad(in, padded, pad_left, left_modes, right_modes);
+            return padded;
+        }
+
+            // Block geometry and estimated cost (in multiply-adds per output point) of
+            // the overlap-add FFT convolution of an array of (padded) size 'shape'.
+            // Each block covers at least three quarters of its FFT size, unless the
+            // entire axis fits into a single transform.
+        template <class SHAPE>
+        inline double fft_convolution_cost(SHAPE const & shape, SHAPE const & ksize,
+                                           SHAPE & fshape, SHAPE & block)
+        {
+            index_t N = shape.size();
+            fshape = SHAPE(N, 0);
+            block  = SHAPE(N, 0);
+            double fsize = 1.0, bsize = 1.0;
+            for(index_t d=0; d<N; ++d)
+            {
+                index_t full = shape[d] + ksize[d] - 1;
+                fshape[d] = fft_size(std::min(full, std::max(4*ksize[d], index_t(32))));
+                block[d]  = std::min(fshape[d] - ksize[d] + 1, shape[d]);
+                fsize *= fshape[d];
+                bsize *= block[d];
+            }
+            // forward and inverse transform of every block (a complex butterfly
+            // costs about 2.5 multiply-adds), plus the product with the spectrum
+            return (5.0 * fsize * std::log2(fsize) + 3.0 * fsize) / bsize;
+        }
+
+            // the SIMD row kernels of the spatial-domain paths are
+            // counted as a quarter of a scalar multiply-add per tap
+        template <class T>
+        inline double spatial_convolution_cost_factor(bool use_simd)
+        {
+#if defined(XVIGRA_USE_SIMD) || defined(XVIGRA_USE_SIMD_DISPATCH)
+            return use_simd && simd_row_types<T, T>::value ? 0.25 : 1.0;
+#else
+            return 1.0;
+#endif
+        }
+    }
+
+    /***********************/
+    /* convolution_functor */
+    /***********************/
+
+        // Non-separable convolution with an N-dimensional kernel whose center
+        // is at 'kernel.shape() / 2'. Borders are handled according to the padding
+        // modes in convolution_options, exactly as in separable_convolution().
+        //
+        // Unless a method is requested via 'convolution_options::use_method()',
+        // a cost model chooses among the following implementations:
+        //  * 2D kernels that are (approximately) sums of few separable terms are
+        //    decomposed by an SVD and executed as a sum of separable_convolution()
+        //    passes (can be disabled via 'convolution_options::use_low_rank(false)').
+        //  * Direct convolution: each output row is computed in tiles by accumulating
+        //    the kernel taps. Floating-point input with contiguous rows is read in
+        //    place, and only the rim of the output goes through a padded_view.
+        //    Other input is first copied into a padded temporary.
+        //  * FFT convolution: the padded input is transformed in blocks, which are
+        //    multiplied with the kernel spectrum and recombined by overlap-add.
+        //
+        // When called with separable kernels (a kernel_1d or a std::vector of them),
+        // the cost model chooses between separable_convolution() and FFT convolution.
+    struct convolution_functor
+    : public functor_base<convolution_functor>
+    {
+        std::string name = "convolution";
+
+        template <class T1, index_t N1, class T2, index_t N2, class T3, index_t N3>
+        void impl(view_nd<T1, N1> const & in, view_nd<T2, N2> out,
+                  view_nd<T3, N3> const & kernel,
+                  convolution_options const & options = convolution_options()) const
+        {
+            using acc_type = std::conditional_t<std::is_integral<std::remove_const_t<T1>>::value,
+                                                float, std::remove_const_t<T1>>;
+            using shape_type = shape_t<N1>;
+
+            vigra_precondition(in.shape() == out.shape(),
+                name + "(): shape mismatch between input and output.");
+            vigra_precondition(!options.has_output_stride(),
+                name + "(): output strides are only supported by separable_convolution().");
+            vigra_precondition(kernel.dimension() == in.dimension(),
+                name + "(): kernel dimension must equal data dimension.");
+            vigra_precondition(kernel.size() > 0,
+                name + "(): kernel must not be empty.");
+
+            shape_type shape(in.shape()),
+                       ksize(kernel.shape()),
+                       center(ksize / 2),
+                       left, pad_left, pad_right, begin, end, fshape, block;
+            if(!detail::convolution_region(shape, ksize, center, options,
+                                           left, pad_left, pad_right, begin, end))
+            {
+                return;
+            }
+            if(options.method == fft_convolution)
+            {
+                impl_fft(in, out, kernel, center, options);
+                return;
+            }
+
+            index_t taps = 0;
+            shape_type k(shape.size(), 0), kbegin(k);
+            do
+            {
+                if(kernel[k] != T3())
+                {
+                    ++taps;
+                }
+            }
+            while(detail::next_scan_index(k, kbegin, ksize, shape.size()));
+
+            double factor = detail::spatial_convolution_cost_factor<acc_type>(options.simd),
+                   direct_cost = factor * std::max<index_t>(taps, 1),
+                   low_rank_cost = std::numeric_limits<double>::infinity(),
+                   fft_cost = options.method == auto_convolution
+                                  ? detail::fft_convolution_cost(shape_type(shape + pad_left + pad_right),
+                                                                 ksize, fshape, block)
+                                  : std::numeric_limits<double>::infinity();
+
+            // 'no_padding' leaves the borders of 'out' untouched, which is
+            // not compatible with the summation of the separable terms
+            bool low_rank = in.dimension() == 2 && options.low_rank;
+            for(index_t d=0; d<(index_t)in.dimension(); ++d)
+            {
+                if(options.get_left_padding(d) == no_padding || options.get_right_padding(d) == no_padding)
+                {
+                    low_rank = false;
+                }
+            }
+            std::vector<std::pair<std::vector<double>, std::vector<double>>> terms;
+            if(low_rank)
+            {
+                std::vector<double> matrix(kernel.size());
+                for(index_t y=0; y<ksize[0]; ++y)
+                {
+                    for(index_t x=0; x<ksize[1]; ++x)
+                    {
+                        matrix[y*ksize[1]+x] = (double)kernel(y, x);
+                    }
+                }
+                terms = detail::separable_kernel_sum(matrix, ksize[0], ksize[1], options.low_rank_tolerance);
+                if(terms.size() > 0)
+                {
+                    low_rank_cost = factor * terms.size() * (ksize[0] + ksize[1] + 1);
+                }
+            }
+
+            if(fft_cost < std::min(direct_cost, low_rank_cost))
+            {
+                impl_fft(in, out, kernel, center, options);
+            }
+            else if(low_rank_cost < direct_cost)
+            {
+                impl_low_rank(in, out, terms, ksize, options);
+            }
+            else
+            {
+                impl_direct(in, out, kernel, center, options);
+            }
+        }
+
+        template <class T1, index_t N1, class T2, index_t N2, class T3>
+        void impl(view_nd<T1, N1> const & in, view_nd<T2, N2> out,
+                  kernel_1d<T3> const & kernel,
+                  convolution_options const & options = convolution_options()) const
+        {
+            impl(in, out, std::vector<kernel_1d<T3>>(in.dimension(), kernel), options);
+        }
+
+        template <class T1, index_t N1, class T2, index_t N2, class Kernels,
+                  VIGRA_REQUIRE<kernel_1d_concept<typename std::decay_t<Kernels>::value_type>::value>>
+        void impl(view_nd<T1, N1> const & in, view_nd<T2, N2> out,
+                  Kernels && kernels,
+                  convolution_options const & options = convolution_options()) const
+        {
+            using acc_type = std::conditional_t<std::is_integral<std::remove_const_t<T1>>::value,
+                                                float, std::remove_const_t<T1>>;
+            using shape_type = shape_t<N1>;
+
+            vigra_precondition(in.shape() == out.shape(),
+                name + "(): shape mismatch between input and output.");
+            vigra_precondition(!options.has_output_stride(),
+                name + "(): output strides are only supported by separable_convolution().");
+            vigra_precondition((index_t)kernels.size() == (index_t)in.dimension(),
+                name + "(): number of kernels doesn't match data dimension.");
+
+            index_t N = in.dimension();
+            shape_type shape(in.shape()), ksize(N, 0), center(N, 0),
+                       left, pad_left, pad_right, begin, end, fshape, block;
+            for(index_t d=0; d<N; ++d)
+            {
+                ksize[d]  = kernels[d].size();
+                center[d] = kernels[d].center();
+            }
+            if(!detail::convolution_region(shape, ksize, center, options,
+                                           left, pad_left, pad_right, begin, end))
+            {
+                return;
+            }
+
+            bool use_fft = options.method == fft_convolution;
+            if(options.method == auto_convolution)
+            {
+                double separable_cost = detail::spatial_convolution_cost_factor<acc_type>(options.simd) * sum(ksize),
+                       fft_cost = detail::fft_convolution_cost(shape_type(shape + pad_left + pad_right),
+                                                               ksize, fshape, block);
+                use_fft = fft_cost < separable_cost;
+            }
+            if(!use_fft)
+            {
+                separable_convolution(in, out, kernels, options);
+                return;
+            }
+
+            // the FFT path needs the kernel as an outer product
+            auto kernel = detail::allocate_temporary<double>(ksize);
+            shape_type k(N, 0), kbegin(N, 0);
+            do
+            {
+                double w = 1.0;
+                for(index_t d=0; d<N; ++d)
+                {
+                    w *= (double)kernels[d](k[d]);
+                }
+                kernel[k] = w;
+            }
+            while(detail::next_scan_index(k, kbegin, ksize, N));
+            impl_fft(in, out, kernel, center, options);
+        }
+
+        template <class T1, index_t N1, class T2, index_t N2>
+        void impl_low_rank(view_nd<T1, N1> const & in, view_nd<T2, N2> out,
+                           std::vector<std::pair<std::vector<double>, std::vector<double>>> const & terms,
+                           shape_t<N1> const & ksize,
+                           convolution_options const & options) const
+        {
+            using acc_type = std::conditional_t<std::is_integral<std::remove_const_t<T1>>::value,
+                                                float, std::remove_const_t<T1>>;
+
+            index_t rank = (index_t)terms.size(),
+                    rows = ksize[0],
+                    cols = ksize[1];
+            XVIGRA_TRACE_SCOPE("low rank " + std::to_string(rank), "stage");
+            auto sum = detail::allocate_aligned_temporary<acc_type>(shape_t<N1>(in.shape()));
+            for(index_t r=0; r<rank; ++r)
+            {
+                std::vector<kernel_1d<acc_type>> kernels{kernel_1d<acc_type>(rows, rows/2),
+                                                         kernel_1d<acc_type>(cols, cols/2)};
+                for(index_t y=0; y<rows; ++y)
+                {
+                    kernels[0](y) = (acc_type)terms[r].first[y];
+                }
+                for(index_t x=0; x<cols; ++x)
+                {
+                    kernels[1](x) = (acc_type)terms[r].second[x];
+                }
+                if(r == 0)
+                {
+                    separable_convolution(in, sum, kernels, options);
+                }
+                else
+                {
+                    auto term = detail::allocate_aligned_temporary<acc_type>(shape_t<N1>(in.shape()));
+                    separable_convolution(in, term, kernels, options);
+                    sum += term;
+                }
+            }
+            out = sum;
+        }
+
+        template <class T1, index_t N1, class T2, index_t N2, class T3, index_t N3>
+        void impl_direct(view_nd<T1, N1> const & in, view_nd<T2, N2> out,
+                         view_nd<T3, N3> const & kernel, shape_t<N1> const & center,
+                         convolution_options const & options) const
+        {
+            using acc_type = std::conditional_t<std::is_integral<std::remove_const_t<T1>>::value,
+                                                float, std::remove_const_t<T1>>;
+            using shape_type = shape_t<N1>;
+
+            index_t N = in.dimension();
+            shape_type shape(in.shape()),
+                       ksize(kernel.shape()),
+                       left, pad_left, pad_right, begin, end;
+            if(!detail::convolution_region(shape, ksize, center, options,
+                                           left, pad_left, pad_right, begin, end))
+            {
+                return;
+            }
+
+            // the taps of the reversed kernel: positions in the neighborhood and weights
+            std::vector<shape_type> positions;
+            std::vector<acc_type>   weights;
+            {
+                shape_type kstrides(kernel.strides()),
+                           k(N, 0), kbegin(N, 0);
+                do
+                {
+                    acc_type w = (acc_type)kernel.raw_data()[dot(kstrides, shape_type(ksize - k - 1))];
+                    if(w != acc_type())
+                    {
+                        positions.push_back(k);
+                        weights.push_back(w);
+                    }
+                }
+                while(detail::next_scan_index(k, kbegin, ksize, N));
+            }
+
+            convolve_direct(std::integral_constant<bool, std::is_same<std::remove_const_t<T1>, acc_type>::value>(),
+                            in, out, positions, weights, left, center, begin, end, pad_left, pad_right, options);
+        }
+
+            // input of the accumulator type: the interior of the output is computed
+            // directly from 'in', and only the border accesses 'in' via padded_view
+        template <class T1, index_t N1, class T2, index_t N2, class T>
+        void convolve_direct(std::true_type, view_nd<T1, N1> const & in, view_nd<T2, N2> out,
+                             std::vector<shape_t<N1>> const & positions, std::vector<T> const & weights,
+                             shape_t<N1> const & left, shape_t<N1> const & right,
+                             shape_t<N1> const & begin, shape_t<N1> const & end,
+                             shape_t<N1> const & pad_left, shape_t<N1> const & pad_right,
+                             convolution_options const & options) const
+        {
+            using shape_type = shape_t<N1>;
+
+            index_t N = in.dimension();
+            if(in.strides(N-1) != 1)
+            {
+                // the row kernels need contiguous input rows
+                convolve_direct(std::false_type(), in, out, positions, weights, left, right,
+                                begin, end, pad_left, pad_right, options);
+                return;
+            }
+
+            tiny_vector<padding_mode> left_modes(N), right_modes(N);
+            for(index_t d=0; d<N; ++d)
+            {
+                left_modes[d]  = options.get_left_padding(d);
+                right_modes[d] = options.get_right_padding(d);
+            }
+            padded_view<T1, N1> padded(in, left_modes, right_modes);
+
+            for(auto const & r : padded.regions(left, right))
+            {
+                shape_type rbegin(max(r.begin, begin)),
+                           rend(min(r.end, end));
+                if(!all_less(rbegin, rend))
+                {
+                    continue;
+                }
+                if(r.border)
+                {
+                    XVIGRA_TRACE_SCOPE("convolve border", "stage");
+                    shape_type x(rbegin);
+                    do
+                    {
+                        T sum = T();
+                        for(std::size_t t=0; t<positions.size(); ++t)
+                        {
+                            sum += weights[t]*padded[shape_type(x - left + positions[t])];
+                        }
+                        out[x] = sum;
+                    }
+                    while(detail::next_scan_index(x, rbegin, rend, N));
+                }
+                else
+                {
+                    convolve_rows(in.raw_data(), in.strides(), shape_type(-left), positions, weights,
+                                  out, rbegin, rend, options.simd);
+                }
+            }
+        }
+
+            // other input types: convert into a padded temporary of the accumulator type
+        template <class T1, index_t N1, class T2, index_t N2, class T>
+        void convolve_direct(std::false_type, view_nd<T1, N1> const & in, view_nd<T2, N2> out,
+                             std::vector<shape_t<N1>> const & positions, std::vector<T> const & weights,
+                             shape_t<N1> const & left, shape_t<N1> const &,
+                             shape_t<N1> const & begin, shape_t<N1> const & end,
+                             shape_t<N1> const & pad_left, shape_t<N1> const & pad_right,
+                             convolution_options const & options) const
+        {
+            auto padded = detail::padded_temporary<T>(in, pad_left, pad_right, options);
+            convolve_rows(padded.raw_data(), padded.strides(), shape_t<N1>(pad_left - left), positions, weights,
+                          out, begin, end, options.simd);
+        }
+
+            // Compute the output points [begin, end), where output point 'x' reads the
+            // source at 'x + shift + positions[t]'. The rows are processed in tiles,
+            // accumulating all kernel taps while a tile is in L1 cache.
+        template <class T, index_t N1, class T2, index_t N2>
+        void convolve_rows(T const * data, shape_t<N1> const & strides, shape_t<N1> const & shift,
+                           std::vector<shape_t<N1>> const & positions, std::vector<T> const & weights,
+                           view_nd<T2, N2> out, shape_t<N1> const & begin, shape_t<N1> const & end,
+                           bool use_simd) const
+        {
+            using shape_type = shape_t<N1>;
+
+#if defined(XVIGRA_USE_SIMD) || defined(XVIGRA_USE_SIMD_DISPATCH)
+            use_simd = use_simd && detail::simd_row_types<T, T>::value;
+#else
+            use_simd = false;
+#endif
+            XVIGRA_TRACE_SCOPE("convolve rows", "stage");
+            index_t last       = (index_t)begin.size() - 1,
+                    taps       = (index_t)positions.size(),
+                    width      = end[last] - begin[last],
+                    tile_width = std::min(width, detail::convolution_tile_width),
+                    os         = out.strides(last);
+            std::vector<index_t> offsets(taps);
+            for(index_t t=0; t<taps; ++t)
+            {
+                offsets[t] = dot(strides, positions[t]);
+            }
+            auto tile = detail::allocate_aligned_temporary<T>(shape_t<1>{tile_width});
+            T * acc = tile.raw_data();
+
+            shape_type x(begin);
+            do
+            {
+                T const * src = data + dot(strides, shape_type(x + shift));
+                T2 * dest = out.raw_data() + dot(out.strides(), x);
+                for(index_t t0=0; t0<width; t0+=tile_width)
+                {
+                    index_t tw = std::min(tile_width, width - t0);
+                    if(taps == 0)
+                    {
+                        std::fill(acc, acc+tw, T());
+                    }
+                    else if(use_simd)
+                    {
+                        detail::simd_mul_row(src + t0 + offsets[0], tw, acc, weights[0]);
+                        for(index_t t=1; t<taps; ++t)
+                        {
+                            detail::simd_fma_row(src + t0 + offsets[t], tw, acc, weights[t]);
+                        }
+                    }
+                    else
+                    {
+                        T const * s = src + t0 + offsets[0];
+                        T w = weights[0];
+                        for(index_t l=0; l<tw; ++l)
+                        {
+                            acc[l] = w*s[l];
+                        }
+                        for(index_t t=1; t<taps; ++t)
+                        {
+                            s = src + t0 + offsets[t];
+                            w = weights[t];
+                            for(index_t l=0; l<tw; ++l)
+                            {
+                                acc[l] += w*s[l];
+                            }
+                        }
+                    }
+                    for(index_t l=0; l<tw; ++l)
+                    {
+                        dest[(t0+l)*os] = acc[l];
+                    }
+                }
+            }
+            while(detail::next_scan_index(x, begin, end, last));
+        }
+
+        template <class T1, index_t N1, class T2, index_t N2, class T3, index_t N3>
+        void impl_fft(view_nd<T1, N1> const & in, view_nd<T2, N2> out,
+                      view_nd<T3, N3> const & kernel, shape_t<N1> const & center,
+                      convolution_options const & options) const
+        {
+            using complex_type = std::complex<double>;
+            using shape_type = shape_t<N1>;
+
+            index_t N = in.dimension();
+            shape_type shape(in.shape()),
+                       ksize(kernel.shape()),
+                       left, pad_left, pad_right, begin, end, fshape, block;
+            if(!detail::convolution_region(shape, ksize, center, options,
+                                           left, pad_left, pad_right, begin, end))
+            {
+                return;
+            }
+            auto padded = detail::padded_temporary<double>(in, pad_left, pad_right, options);
+            shape_type pshape(padded.shape());
+            detail::fft_convolution_cost(pshape, ksize, fshape, block);
+            XVIGRA_TRACE_SCOPE("fft", "stage");
+
+            shape_type zero(N, 0), k(zero);
+            auto spectrum = detail::allocate_temporary<complex_type>(fshape);
+            do
+            {
+                spectrum[k] = complex_type((double)kernel[k]);
+            }
+            while(detail::next_scan_index(k, zero, ksize, N));
+            fourier_transform(spectrum);
+
+            // overlap-add: the full convolutions of the blocks are summed up in 'full'
+            auto full   = detail::allocate_temporary<double>(shape_type(pshape + ksize - 1));
+            auto buffer = detail::allocate_temporary<complex_type>(fshape);
+            shape_type blocks((pshape + block - 1) / block), b(zero);
+            do
+            {
+                shape_type origin(b * block),
+                           bsize(min(block, shape_type(pshape - origin))),
+                           fsize(bsize + ksize - 1);
+                std::fill(buffer.raw_data(), buffer.raw_data() + buffer.size(), complex_type());
+                k = zero;
+                do
+                {
+                    buffer[k] = complex_type(padded[shape_type(origin + k)]);
+                }
+                while(detail::next_scan_index(k, zero, bsize, N));
+                fourier_transform(buffer);
+                for(index_t i=0; i<buffer.size(); ++i)
+                {
+                    buffer.raw_data()[i] *= spectrum.raw_data()[i];
+                }
+                fourier_transform(buffer, true);
+                k = zero;
+                do
+                {
+                    full[shape_type(origin + k)] += buffer[k].real();
+                }
+                while(detail::next_scan_index(k, zero, fsize, N));
+            }
+            while(detail::next_scan_index(b, zero, blocks, N));
+
+            // output point 'x' corresponds to 'x + center + pad_left' in the full convolution
+            shape_type x(begin), offset(center + pad_left);
+            do
+            {
+                out[x] = full[shape_type(x + offset)];
+            }
+            while(detail::next_scan_index(x, begin, end, N));
+        }
+    };
+
+    namespace
+    {
+        convolution_functor  convolution;
+
+        inline void convolution_dummy()
+        {
+            std::ignore = convolution;
+        }
+    }
+
+}
+
+#endif // XVIGRA_CONVOLUTION_HPP
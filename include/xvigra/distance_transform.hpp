@@ -31,6 +31,7 @@
 #ifndef XVIGRA_DISTANCE_TRANSFORM_HPP
 #define XVIGRA_DISTANCE_TRANSFORM_HPP
 
+#include <algorithm>
 #include <vector>
 #include <xtensor/xeval.hpp>
 #include "global.hpp"
@@ -38,6 +39,7 @@
 #include "math.hpp"
 #include "slice.hpp"
 #include "functor_base.hpp"
+#include "simd_dispatch.hpp"
 
 namespace xvigra
 {
@@ -55,6 +57,57 @@ namespace xvigra
             {}
         };
 
+        /****************/
+        /* parabola_row */
+        /****************/
+
+            // out(k) = sigma2 * (k - center)^2 + apex for k in [begin, end)
+        template <class T, index_t N>
+        inline void parabola_row(view_nd<T, N> & out, index_t begin, index_t end,
+                                 double sigma2, double center, double apex)
+        {
+            for(index_t k=begin; k<end; ++k)
+            {
+                out(k) = sigma2 * sq(k - center) + apex;
+            }
+        }
+
+    #ifdef XVIGRA_USE_SIMD_DISPATCH
+        template <index_t N>
+        inline void parabola_row(view_nd<float, N> & out, index_t begin, index_t end,
+                                 double sigma2, double center, double apex)
+        {
+            if(out.is_contiguous())
+            {
+                dispatch_parabola_row(out.raw_data(), begin, end, sigma2, center, apex);
+            }
+            else
+            {
+                for(index_t k=begin; k<end; ++k)
+                {
+                    out(k) = sigma2 * sq(k - center) + apex;
+                }
+            }
+        }
+
+        template <index_t N>
+        inline void parabola_row(view_nd<double, N> & out, index_t begin, index_t end,
+                                 double sigma2, double center, double apex)
+        {
+            if(out.is_contiguous())
+            {
+                dispatch_parabola_row(out.raw_data(), begin, end, sigma2, center, apex);
+            }
+            else
+            {
+                for(index_t k=begin; k<end; ++k)
+                {
+                    out(k) = sigma2 * sq(k - center) + apex;
+                }
+            }
+        }
+    #endif
+
         /*********************/
         /* distance_parabola */
         /*********************/
@@ -119,15 +172,13 @@ namespace xvigra
             // Now we have the stack indicating which points are influenced by (and therefore
             // closest to) which other point. We can go through the stack and calculate the
             // distance squared for each point.
+            // Each stack entry covers the points in [k, ceil(right)).
             k = 0;
-            auto it = _stack.begin();
-            for(double current = 0.0; current < w; ++current, ++k)
+            for(auto it = _stack.begin(); k < (index_t)w; ++it)
             {
-                while( current >= it->right)
-                {
-                    ++it;
-                }
-                out(k) = sigma2 * sq(current - it->center) + it->apex_height;
+                index_t end = std::min((index_t)w, (index_t)std::ceil(it->right));
+                parabola_row(out, k, end, sigma2, it->center, it->apex_height);
+                k = std::max(k, end);
             }
         }
 
@@ -144,22 +195,24 @@ namespace xvigra
             // unless one wants to account for anisotropic pixel pitch.
             index_t N = in.dimension();
 
-            slicer nav(in.shape());
-
             // operate on last dimension first
-            nav.set_free_axes(N-1);
-            for(; nav.has_more(); ++nav)
             {
-                distance_parabola(in.view(*nav), out.view(*nav), sigmas[N-1], invert);
+                XVIGRA_TRACE_SCOPE("axis " + std::to_string(N-1), "stage");
+                auto in_lines  = in.lines(N-1);
+                auto out_lines = out.lines(N-1);
+                for(; in_lines.has_more(); ++in_lines, ++out_lines)
+                {
+                    distance_parabola(*in_lines, *out_lines, sigmas[N-1], invert);
+                }
             }
 
             // operate on further dimensions
             for( index_t d = N-2; d >= 0; --d )
             {
-                nav.set_free_axes(d);
-                for(; nav.has_more(); ++nav)
+                XVIGRA_TRACE_SCOPE("axis " + std::to_string(d), "stage");
+                for(auto line = out.lines(d); line.has_more(); ++line)
                 {
-                    distance_parabola(out.view(*nav), out.view(*nav), sigmas[d], invert);
+                    distance_parabola(*line, *line, sigmas[d], invert);
                 }
             }
         }
@@ -193,7 +246,7 @@ namespace xvigra
             if(std::is_integral<T2>::value && (pitch_is_real || inf > (double)highest))
             {
                 // work on a real-valued temporary array
-                array_nd<real_promote_type_t<T2>, N2> tmp(out.shape());
+                auto tmp = detail::allocate_temporary<real_promote_type_t<T2>>(out.shape());
                 if(background)
                 {
                     tmp = where(equal(in, 0), inf, 0.0);
@@ -0,0 +1,210 @@
+/************************************************************************/
+/*                                                                      */
+/*     Copyright 2017-2018 by Ullrich Koethe                            */
+/*                                                                      */
+/*    This file is part of the XVIGRA image analysis library.           */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+
+#ifndef XVIGRA_FFT_HPP
+#define XVIGRA_FFT_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <vector>
+#include "global.hpp"
+#include "error.hpp"
+#include "array_nd.hpp"
+
+namespace xvigra
+{
+    /************/
+    /* fft_plan */
+    /************/
+
+        // smallest power of two >= n
+    inline index_t fft_size(index_t n)
+    {
+        index_t res = 1;
+        while(res < n)
+        {
+            res *= 2;
+        }
+        return res;
+    }
+
+        // Precomputed bit-reversal permutation and twiddle factors for
+        // in-place radix-2 FFTs of length 'size()' (a power of two).
+    template <class T>
+    class fft_plan
+    {
+      public:
+        using value_type = std::complex<T>;
+
+        explicit fft_plan(index_t n)
+        : size_(n),
+          bitrev_(n),
+          twiddles_(n/2)
+        {
+            vigra_precondition(n > 0 && fft_size(n) == n,
+                "fft_plan(): size must be a power of two.");
+            index_t bits = 0;
+            while((index_t(1) << bits) < n)
+            {
+                ++bits;
+            }
+            for(index_t k=0; k<n; ++k)
+            {
+                index_t r = 0;
+                for(index_t b=0; b<bits; ++b)
+                {
+                    r |= ((k >> b) & 1) << (bits - 1 - b);
+                }
+                bitrev_[k] = r;
+            }
+            for(index_t k=0; k<n/2; ++k)
+            {
+                double phi = -2.0 * M_PI * k / n;
+                twiddles_[k] = value_type(T(std::cos(phi)), T(std::sin(phi)));
+            }
+        }
+
+        index_t size() const
+        {
+            return size_;
+        }
+
+            // transform 'size()' contiguous elements, the inverse
+            // transform includes the normalization by '1 / size()'
+        void operator()(value_type * data, bool inverse = false) const
+        {
+            for(index_t k=0; k<size_; ++k)
+            {
+                if(k < bitrev_[k])
+                {
+                    std::swap(data[k], data[bitrev_[k]]);
+                }
+            }
+            for(index_t half=1, step=size_/2; half<size_; half*=2, step/=2)
+            {
+                for(index_t k=0; k<size_; k+=2*half)
+                {
+                    for(index_t j=0; j<half; ++j)
+                    {
+                        value_type w = inverse ? std::conj(twiddles_[j*step]) : twiddles_[j*step],
+                                   u = data[k+j],
+                                   v = data[k+j+half]*w;
+                        data[k+j]      = u + v;
+                        data[k+j+half] = u - v;
+                    }
+                }
+            }
+            if(inverse)
+            {
+                T norm = T(1.0 / size_);
+                for(index_t k=0; k<size_; ++k)
+                {
+                    data[k] *= norm;
+                }
+            }
+        }
+
+      private:
+        index_t size_;
+        std::vector<index_t> bitrev_;
+        std::vector<value_type> twiddles_;
+    };
+
+    /*********************/
+    /* fourier_transform */
+    /*********************/
+
+    namespace detail
+    {
+            // axis_x <-> axis_fx etc.
+        inline tags::axis_tag fourier_axistag(tags::axis_tag tag, bool inverse)
+        {
+            if(!inverse && tag >= tags::axis_x && tag <= tags::axis_t)
+            {
+                return tags::axis_tag(tag + (tags::axis_fx - tags::axis_x));
+            }
+            if(inverse && tag >= tags::axis_fx && tag <= tags::axis_ft)
+            {
+                return tags::axis_tag(tag - (tags::axis_fx - tags::axis_x));
+            }
+            return tag;
+        }
+    }
+
+        // In-place N-dimensional FFT of complex data whose shape consists of powers
+        // of two. Spatial axis tags are replaced with the corresponding Fourier
+        // tags (and vice versa for the inverse transform).
+    template <class T, index_t N>
+    void fourier_transform(view_nd<std::complex<T>, N> & data, bool inverse = false)
+    {
+        std::vector<std::complex<T>> buffer;
+        for(index_t d=0; d<(index_t)data.dimension(); ++d)
+        {
+            index_t n = data.shape(d);
+            if(n == 1)
+            {
+                continue;
+            }
+            fft_plan<T> plan(n);
+            for(auto line = data.lines(d); line.has_more(); ++line)
+            {
+                auto l = *line;
+                if(l.strides(0) == 1)
+                {
+                    plan(l.raw_data(), inverse);
+                }
+                else
+                {
+                    buffer.resize(n);
+                    for(index_t k=0; k<n; ++k)
+                    {
+                        buffer[k] = l(k);
+                    }
+                    plan(buffer.data(), inverse);
+                    for(index_t k=0; k<n; ++k)
+                    {
+                        l(k) = buffer[k];
+                    }
+                }
+            }
+        }
+
+        auto axistags = data.axistags();
+        for(index_t d=0; d<(index_t)axistags.size(); ++d)
+        {
+            axistags[d] = detail::fourier_axistag(axistags[d], inverse);
+        }
+        data.set_axistags(axistags);
+    }
+}
+
+#endif // XVIGRA_FFT_HPP
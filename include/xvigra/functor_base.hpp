@@ -31,11 +31,53 @@
 #ifndef XVIGRA_FUNCTOR_BASE_HPP
 #define XVIGRA_FUNCTOR_BASE_HPP
 
+#include <vector>
 #include "global.hpp"
 #include "array_nd.hpp"
+#include "instrumentation.hpp"
+#include "trace.hpp"
 
 namespace xvigra
 {
+    namespace detail
+    {
+            // allocate a temporary array for an algorithm, reporting it
+            // to the instrumentation and tracing layers (if enabled)
+        template <class T, index_t N>
+        array_nd<T, N> allocate_temporary(shape_t<N> const & shape)
+        {
+            XVIGRA_TRACE_SCOPE("allocate temporary", "stage");
+            array_nd<T, N> res(shape);
+            XVIGRA_INSTRUMENT_TEMPORARY(res.size()*sizeof(T));
+            return res;
+        }
+
+            // like allocate_temporary(), but with aligned rows
+        template <class T, index_t N>
+        array_nd<T, N> allocate_aligned_temporary(shape_t<N> const & shape)
+        {
+            XVIGRA_TRACE_SCOPE("allocate temporary", "stage");
+            array_nd<T, N> res(shape, aligned_rows);
+            XVIGRA_INSTRUMENT_TEMPORARY(res.size()*sizeof(T));
+            return res;
+        }
+
+            // Per-thread scratch line with room for at least 'size' elements. The
+            // memory is reused by subsequent calls with the same type 'T' (previous
+            // contents are lost), so that per-row temporaries need no allocation.
+        template <class T>
+        T * line_buffer(index_t size)
+        {
+            thread_local std::vector<T> buffer;
+            if((index_t)buffer.size() < size)
+            {
+                XVIGRA_INSTRUMENT_TEMPORARY((size - buffer.size())*sizeof(T));
+                buffer.resize(size);
+            }
+            return buffer.data();
+        }
+    }
+
     /****************/
     /* functor_base */
     /****************/
@@ -56,24 +98,55 @@ namespace xvigra
             return derived_cast().name;
         }
 
-        // FIXME: functor_base should support value_type=tiny_vector
-
-        template <class E1, class E2, class ... ARGS>
+        template <class E1, class E2,
+                  VIGRA_REQUIRE<!planar_view_nd_concept<E1>::value>,
+                  class ... ARGS>
         void operator()(E1 && e1, E2 && e2, ARGS ... a) const
         {
+            XVIGRA_INSTRUMENT_SCOPE(name());
+            XVIGRA_TRACE_SCOPE(name(), "functor");
             auto && a1 = eval_expr(std::forward<E1>(e1));
             auto && a2 = eval_expr(std::forward<E2>(e2));
-            derived_cast().impl(make_view(a1), make_view(a2), std::forward<ARGS>(a)...);
+            using T1 = typename std::decay_t<decltype(make_view(a1))>::value_type;
+            XVIGRA_INSTRUMENT_EVAL(E1, a1);
+            XVIGRA_INSTRUMENT_IO(a1.size(), a1.size()*sizeof(*make_view(a1).raw_data()),
+                                 a2.size()*sizeof(*make_view(a2).raw_data()));
+            impl_dispatch(tiny_vector_concept<std::remove_const_t<T1>>(),
+                          make_view(a1), make_view(a2), std::forward<ARGS>(a)...);
+        }
+
+            // process planar multi-channel arrays one contiguous plane at a time
+        template <class P1, class P2,
+                  VIGRA_REQUIRE<planar_view_nd_concept<P1>::value && planar_view_nd_concept<P2>::value>,
+                  class ... ARGS>
+        void operator()(P1 const & p1, P2 const & p2, ARGS ... a) const
+        {
+            XVIGRA_INSTRUMENT_SCOPE(name());
+            XVIGRA_TRACE_SCOPE(name(), "functor");
+            vigra_precondition(p1.channels() == p2.channels(),
+                name() + "(): number of channels mismatch between input and output.");
+            for(index_t c=0; c<p1.channels(); ++c)
+            {
+                auto c1 = p1.channel(c);
+                auto c2 = p2.channel(c);
+                XVIGRA_INSTRUMENT_IO(c1.size(), c1.size()*sizeof(*c1.raw_data()), c2.size()*sizeof(*c2.raw_data()));
+                derived_cast().impl(c1, c2, a...);
+            }
         }
 
         template <class E1, class E2, class ... ARGS>
         void operator()(dimension_hint dim, E1 && e1, E2 && e2, ARGS ... a) const
         {
+            XVIGRA_INSTRUMENT_SCOPE(name());
+            XVIGRA_TRACE_SCOPE(name(), "functor");
             vigra_precondition((index_t)e1.dimension() == dim || (index_t)e1.dimension() == dim+1,
                 name() + "(): input dimension contradicts dimension_hint.");
 
             auto && a1 = eval_expr(std::forward<E1>(e1));
             auto && a2 = eval_expr(std::forward<E2>(e2));
+            XVIGRA_INSTRUMENT_EVAL(E1, a1);
+            XVIGRA_INSTRUMENT_IO(a1.size(), a1.size()*sizeof(*make_view(a1).raw_data()),
+                                 a2.size()*sizeof(*make_view(a2).raw_data()));
 
             if((index_t)a1.dimension() == dim)
             {
@@ -85,10 +158,42 @@ namespace xvigra
                 auto && v2 = make_view(a2);
                 for(index_t k=0; k<v1.shape(dim); ++k)
                 {
-                    derived_cast().impl(v1.bind(dim, k), v2.bind(dim, k), std::forward<ARGS>(a)...);
+                    derived_cast().impl(v1.bind(dim, k), v2.bind(dim, k), a...);
                 }
             }
         }
+
+      private:
+
+            // scalar pixels: call the algorithm directly
+        template <class V1, class V2, class ... ARGS>
+        void impl_dispatch(std::false_type, V1 && v1, V2 && v2, ARGS && ... a) const
+        {
+            derived_cast().impl(std::forward<V1>(v1), std::forward<V2>(v2), std::forward<ARGS>(a)...);
+        }
+
+            // tiny_vector pixels: copy one channel at a time into contiguous
+            // temporary arrays and run the algorithm on these planes
+        template <class T1, index_t N1, class T2, index_t N2, class ... ARGS>
+        void impl_dispatch(std::true_type, view_nd<T1, N1> v1, view_nd<T2, N2> v2, ARGS && ... a) const
+        {
+            static_assert(tiny_vector_concept<std::remove_const_t<T2>>::value &&
+                          std::remove_const_t<T1>::static_size == std::remove_const_t<T2>::static_size,
+                "functor_base: input and output must have the same number of channels.");
+            static_assert(std::remove_const_t<T1>::static_size != runtime_size,
+                "functor_base: tiny_vector pixels must have a fixed number of channels.");
+            using V1 = typename std::remove_const_t<T1>::value_type;
+            using V2 = typename std::remove_const_t<T2>::value_type;
+
+            auto plane1 = detail::allocate_temporary<V1>(v1.shape());
+            auto plane2 = detail::allocate_temporary<V2>(v2.shape());
+            for(index_t c=0; c<std::remove_const_t<T1>::static_size; ++c)
+            {
+                plane1 = v1.bind_channel(c);
+                derived_cast().impl(plane1.view(), plane2.view(), a...);
+                v2.bind_channel(c) = plane2;
+            }
+        }
     };
 }
 
@@ -89,10 +89,14 @@ namespace xvigra
 
         struct view_nd_tag {};
 
+        struct planar_view_nd_tag {};
+
         struct kernel_1d_tag {};
 
         struct skip_initialization_tag {};
 
+        struct aligned_rows_tag {};
+
         using memory_order = xt::layout_type;
 
     } // namespace tags
@@ -106,10 +110,12 @@ namespace xvigra
     namespace
     {
         tags::skip_initialization_tag  dont_init;
+        tags::aligned_rows_tag         aligned_rows;
 
         inline void skip_initialization_dummy()
         {
             std::ignore = dont_init;
+            std::ignore = aligned_rows;
         }
     }
 
@@ -31,13 +31,101 @@
 #ifndef XVIGRA_IMAGE_IO_HPP
 #define XVIGRA_IMAGE_IO_HPP
 
+#include <algorithm>
+#include <memory>
+#include <string>
 #include <OpenImageIO/imageio.h>
 #include <xtensor/xmath.hpp>
 #include <xtensor/xeval.hpp>
 #include "array_nd.hpp"
+#include "parallel.hpp"
 
 namespace xvigra
 {
+    namespace detail
+    {
+        struct image_input_closer
+        {
+            void operator()(OIIO::ImageInput * file) const
+            {
+                file->close();
+                OIIO::ImageInput::destroy(file);
+            }
+        };
+
+        using image_input_ptr = std::unique_ptr<OIIO::ImageInput, image_input_closer>;
+
+        inline image_input_ptr
+        open_image_input(std::string const & filename, std::string const & caller)
+        {
+            image_input_ptr in(OIIO::ImageInput::open(filename));
+            vigra_precondition(!!in,
+                caller + "(): Error reading image '" + filename + "'.");
+            return in;
+        }
+    }
+
+    /**************/
+    /* image_info */
+    /**************/
+
+        /** \brief Properties of an image file, as returned by read_image_info().
+        */
+    struct image_info
+    {
+        explicit
+        image_info(OIIO::ImageSpec const & spec)
+        : width(spec.width)
+        , height(spec.height)
+        , depth(spec.depth)
+        , channels(spec.nchannels)
+        , tile_width(spec.tile_width)
+        , tile_height(spec.tile_height)
+        , subimages(1)
+        , format(spec.format)
+        {}
+
+            /** \brief Shape of the array returned by read_image():
+                ``HEIGHT x WIDTH`` or ``HEIGHT x WIDTH x CHANNELS``.
+            */
+        shape_t<> shape() const
+        {
+            shape_t<> res{height, width};
+            if(channels > 1)
+            {
+                res = res.push_back(channels);
+            }
+            return res;
+        }
+
+        bool is_tiled() const
+        {
+            return tile_width > 0;
+        }
+
+        index_t width, height, depth, channels;
+        index_t tile_width, tile_height;   // zero for scanline images
+        index_t subimages;                 // pages of a multi-page file (set by read_image_info())
+        OIIO::TypeDesc format;
+    };
+
+    /**
+     * Get the properties of an image file without reading the pixel data.
+     *
+     * @param filename The path of the file
+     */
+    inline image_info read_image_info(std::string filename)
+    {
+        auto in = detail::open_image_input(filename, "read_image_info");
+        image_info res(in->spec());
+        OIIO::ImageSpec spec;
+        while(in->seek_subimage(res.subimages, 0, spec))
+        {
+            ++res.subimages;
+        }
+        return res;
+    }
+
     /**
      * Load an image from file at filename.
      * Storage format is deduced from file ending.
@@ -51,31 +139,299 @@ namespace xvigra
     template <class T = float>
     array_nd<T> read_image(std::string filename)
     {
-        auto close_file  =  [](OIIO::ImageInput * file)
-                            {
-                                file->close();
-                                OIIO::ImageInput::destroy(file);
-                            };
+        auto in = detail::open_image_input(filename, "read_image");
 
-        std::unique_ptr<OIIO::ImageInput, decltype(close_file)> in(OIIO::ImageInput::open(filename), close_file);
-        vigra_precondition(!!in,
-            "read_image(): Error reading image '" + filename + "'.");
+        array_nd<T> image(image_info(in->spec()).shape());
 
-        const OIIO::ImageSpec& spec = in->spec();
+        in->read_image(OIIO::BaseTypeFromC<T>::value, image.raw_data());
 
-        shape_t<> shape{spec.height, spec.width};
-        if(spec.nchannels > 1)
+        return image;
+    }
+
+    namespace detail
+    {
+            // view of shape HEIGHT x WIDTH x CHANNELS for a 2- or 3-dimensional view
+        template <class T, index_t N>
+        view_nd<T, 3> image_view_3d(view_nd<T, N> const & v, std::string const & caller)
         {
-            shape = shape.push_back(spec.nchannels);
+            vigra_precondition(v.dimension() == 2 || v.dimension() == 3,
+                caller + "(): array must have 2 or 3 dimensions (channels must be last).");
+            bool has_channels = v.dimension() == 3;
+            return view_nd<T, 3>(shape_t<3>{v.shape(0), v.shape(1), has_channels ? v.shape(2) : 1},
+                                 shape_t<3>{v.strides(0), v.strides(1), has_channels ? v.strides(2) : 1},
+                                 const_cast<T *>(v.raw_data()));
         }
 
-        array_nd<T> image(shape);
+        template <class T, index_t N>
+        void read_image_region_impl(OIIO::ImageInput & in, view_nd<T, N> const & out,
+                                    shape_t<2> const & top_left, std::string const & caller)
+        {
+            OIIO::ImageSpec const & spec = in.spec();
+            OIIO::TypeDesc format = OIIO::BaseTypeFromC<T>::value;
+            view_nd<T, 3> dest = image_view_3d(out, caller);
 
-        in->read_image(OIIO::BaseTypeFromC<T>::value, image.raw_data());
+            index_t y0 = top_left[0], x0 = top_left[1],
+                    h  = dest.shape(0), w  = dest.shape(1), c = dest.shape(2);
+            vigra_precondition(0 <= y0 && y0 + h <= spec.height && 0 <= x0 && x0 + w <= spec.width,
+                caller + "(): region is outside the image.");
+            vigra_precondition(c <= spec.nchannels,
+                caller + "(): array has more channels than the image.");
+            if(h == 0 || w == 0)
+                return;
 
-        return image;
+            if(spec.tile_width > 0)
+            {
+                // tiled image: read only the tiles that intersect the region,
+                // one row of tiles at a time
+                index_t tw = spec.tile_width,
+                        th = spec.tile_height,
+                        bx0 = x0 - x0 % tw,
+                        bx1 = std::min<index_t>((x0 + w + tw - 1) / tw * tw, spec.width);
+                array_nd<T, 3> tiles(shape_t<3>{th, bx1 - bx0, c});
+                for(index_t by = y0 - y0 % th; by < y0 + h; by += th)
+                {
+                    index_t by1 = std::min<index_t>(by + th, spec.height);
+                    bool ok = in.read_tiles(spec.x + bx0, spec.x + bx1, spec.y + by, spec.y + by1,
+                                            spec.z, spec.z + 1, 0, c, format, tiles.raw_data());
+                    vigra_precondition(ok, caller + "(): " + in.geterror());
+                    index_t ry0 = std::max(by, y0),
+                            ry1 = std::min(by1, y0 + h);
+                    dest.subarray(shape_t<3>{ry0 - y0, 0, 0}, shape_t<3>{ry1 - y0, w, c}) =
+                        tiles.subarray(shape_t<3>{ry0 - by, x0 - bx0, 0}, shape_t<3>{ry1 - by, x0 - bx0 + w, c});
+                }
+            }
+            else if(x0 == 0 && w == spec.width && (c == 1 || dest.strides(2) == 1))
+            {
+                // full scanlines: let OpenImageIO write directly into 'out'
+                bool ok = in.read_scanlines(spec.y + y0, spec.y + y0 + h, spec.z, 0, c, format, dest.raw_data(),
+                                            dest.strides(1)*sizeof(T), dest.strides(0)*sizeof(T));
+                vigra_precondition(ok, caller + "(): " + in.geterror());
+            }
+            else
+            {
+                // partial scanlines: read each line into a buffer and copy the region
+                array_nd<T, 2> line(shape_t<2>{spec.width, c});
+                for(index_t y = 0; y < h; ++y)
+                {
+                    bool ok = in.read_scanlines(spec.y + y0 + y, spec.y + y0 + y + 1, spec.z, 0, c,
+                                                format, line.raw_data());
+                    vigra_precondition(ok, caller + "(): " + in.geterror());
+                    dest.bind(0, y) = line.subarray(shape_t<2>{x0, 0}, shape_t<2>{x0 + w, c});
+                }
+            }
+        }
     }
 
+    namespace detail
+    {
+        template <class T, index_t N>
+        void read_subimage_into(OIIO::ImageInput & in, view_nd<T, N> const & out,
+                                index_t subimage, std::string const & caller)
+        {
+            if(in.current_subimage() != subimage)
+            {
+                OIIO::ImageSpec spec;
+                vigra_precondition(in.seek_subimage(subimage, 0, spec),
+                    caller + "(): subimage " + std::to_string(subimage) + " doesn't exist.");
+            }
+            OIIO::ImageSpec const & spec = in.spec();
+            view_nd<T, 3> dest = image_view_3d(out, caller);
+            vigra_precondition(dest.shape(0) == spec.height && dest.shape(1) == spec.width,
+                caller + "(): shape mismatch between array and image.");
+
+            index_t c = dest.shape(2);
+            if(c == spec.nchannels && (c == 1 || dest.strides(2) == 1))
+            {
+                // pixels are contiguous: let OpenImageIO write directly into 'out'
+                bool ok = in.read_image(OIIO::BaseTypeFromC<T>::value, dest.raw_data(),
+                                        dest.strides(1)*sizeof(T), dest.strides(0)*sizeof(T));
+                vigra_precondition(ok, caller + "(): " + in.geterror());
+            }
+            else
+            {
+                read_image_region_impl(in, out, shape_t<2>{0, 0}, caller);
+            }
+        }
+    }
+
+    /**
+     * Load an image into a caller-provided array without allocating memory.
+     *
+     * @param filename The path of the file to load
+     * @param out      Array of shape ``HEIGHT x WIDTH`` or ``HEIGHT x WIDTH x CHANNELS``
+     *                 with arbitrary strides. If it has fewer channels than the
+     *                 file, only the first channels are read.
+     * @param subimage Index of the subimage (page) to read in a multi-page file
+     */
+    template <class T, index_t N>
+    void read_image_into(std::string filename, view_nd<T, N> out, index_t subimage = 0)
+    {
+        auto in = detail::open_image_input(filename, "read_image_into");
+        detail::read_subimage_into(*in, out, subimage, "read_image_into");
+    }
+
+    /**
+     * Load the subimages (pages) of a multi-page file (e.g. a TIFF stack)
+     * into the slices of a caller-provided array.
+     *
+     * @param filename     The path of the file to load
+     * @param out          Array of shape ``PAGES x HEIGHT x WIDTH`` or
+     *                     ``PAGES x HEIGHT x WIDTH x CHANNELS``. The pages
+     *                     ``0 ... PAGES-1`` are read.
+     * @param thread_count Number of threads (each thread opens the file separately,
+     *                     <tt>thread_count <= 0</tt> means 'default_thread_count()')
+     */
+    template <class T, index_t N>
+    void read_volume_into(std::string filename, view_nd<T, N> out, index_t thread_count = 1)
+    {
+        vigra_precondition(out.dimension() == 3 || out.dimension() == 4,
+            "read_volume_into(): array must have 3 or 4 dimensions (channels must be last).");
+        if(thread_count <= 0)
+        {
+            thread_count = default_thread_count();
+        }
+        // one chunk of consecutive pages per thread, so that each thread
+        // opens the file only once
+        index_t pages = out.shape(0),
+                grain_size = std::max<index_t>(1, (pages + thread_count - 1) / thread_count);
+        parallel_for(pages,
+            [&](index_t begin, index_t end)
+            {
+                auto in = detail::open_image_input(filename, "read_volume_into");
+                for(index_t page = begin; page < end; ++page)
+                {
+                    detail::read_subimage_into(*in, out.bind(0, page), page, "read_volume_into");
+                }
+            },
+            thread_count, grain_size);
+    }
+
+    /**
+     * Load all subimages (pages) of a multi-page file (e.g. a TIFF stack).
+     * All pages must have the same shape.
+     *
+     * @return array_nd of shape ``PAGES x HEIGHT x WIDTH x CHANNELS`` (the channel
+     *         axis is omitted for single-channel images).
+     */
+    template <class T = float>
+    array_nd<T> read_volume(std::string filename, index_t thread_count = 1)
+    {
+        image_info info = read_image_info(filename);
+        array_nd<T> volume(info.shape().insert(0, info.subimages));
+        read_volume_into(filename, volume, thread_count);
+        return volume;
+    }
+
+    /**
+     * Load a region of an image into a caller-provided array.
+     *
+     * Only the scanlines (or, for tiled files, the tiles) that intersect
+     * the region are read from the file.
+     *
+     * @param filename The path of the file to load
+     * @param out      Array of shape ``HEIGHT x WIDTH`` or ``HEIGHT x WIDTH x CHANNELS``,
+     *                 which determines the size of the region. If it has fewer
+     *                 channels than the file, only the first channels are read.
+     * @param top_left Coordinate ``(y, x)`` of the region's upper left corner
+     */
+    template <class T, index_t N>
+    void read_image_region(std::string filename, view_nd<T, N> out,
+                           shape_t<2> const & top_left = shape_t<2>{0, 0})
+    {
+        auto in = detail::open_image_input(filename, "read_image_region");
+        detail::read_image_region_impl(*in, out, top_left, "read_image_region");
+    }
+
+    /*******************/
+    /* scanline_reader */
+    /*******************/
+
+        /** \brief Read an image sequentially in chunks of scanlines.
+
+            Only the current chunk is held in memory, so that algorithms can
+            process images that are much larger than the available memory.
+            Following the protocol of 'slicer', the reader is advanced by
+            'operator++' until 'has_more()' returns false. 'operator*' returns
+            the current chunk as a view of shape ``ROWS x WIDTH x CHANNELS``,
+            which remains valid until the reader is advanced.
+
+            <b>Usage:</b>
+            \code
+            for(scanline_reader<float> reader("huge.tif", 64); reader.has_more(); ++reader)
+            {
+                view_nd<float, 3> rows = *reader;  // rows reader.row() ... reader.row()+rows.shape(0)-1
+                ...
+            }
+            \endcode
+        */
+    template <class T = float>
+    class scanline_reader
+    {
+      public:
+        explicit
+        scanline_reader(std::string filename, index_t rows_per_chunk = 1)
+        : in_(detail::open_image_input(filename, "scanline_reader"))
+        , info_(in_->spec())
+        , row_(0)
+        , rows_(0)
+        , buffer_(shape_t<3>{std::max<index_t>(1, std::min(rows_per_chunk, info_.height)),
+                             info_.width, info_.channels})
+        {
+            read_chunk();
+        }
+
+        bool has_more() const
+        {
+            return row_ < info_.height;
+        }
+
+        void operator++()
+        {
+            row_ += rows_;
+            read_chunk();
+        }
+
+            // the current chunk of scanlines
+        view_nd<T, 3> operator*() const
+        {
+            return buffer_.subarray(shape_t<3>{0, 0, 0},
+                                    shape_t<3>{rows_, info_.width, info_.channels});
+        }
+
+            // index of the first scanline in the current chunk
+        index_t row() const
+        {
+            return row_;
+        }
+
+        image_info const & info() const
+        {
+            return info_;
+        }
+
+      private:
+        void read_chunk()
+        {
+            if(!has_more())
+            {
+                rows_ = 0;
+                return;
+            }
+            OIIO::ImageSpec const & spec = in_->spec();
+            rows_ = std::min(buffer_.shape(0), info_.height - row_);
+            bool ok = in_->read_scanlines(spec.y + row_, spec.y + row_ + rows_, spec.z,
+                                          0, info_.channels, OIIO::BaseTypeFromC<T>::value,
+                                          buffer_.raw_data());
+            vigra_precondition(ok,
+                "scanline_reader: " + in_->geterror());
+        }
+
+        detail::image_input_ptr in_;
+        image_info info_;
+        index_t row_, rows_;
+        array_nd<T, 3> buffer_;
+    };
+
         /** \brief Pass options to write_image().
         */
     struct write_image_options
@@ -107,6 +463,26 @@ namespace xvigra
         bool autoconvert;
     };
 
+    namespace detail
+    {
+            // Copy row 'y' of a 2D or 3D expression into the interleaved buffer 'dest',
+            // transforming each value by 'f'.
+        template <class E, class T, class F>
+        void write_image_row(E const & e, index_t y, index_t width, index_t channels,
+                             T * dest, F f)
+        {
+            shape_t<3> index{y, 0, 0};
+            auto end = index.begin() + e.dimension();
+            for(; index[1] < width; ++index[1])
+            {
+                for(index[2] = 0; index[2] < channels; ++index[2], ++dest)
+                {
+                    *dest = static_cast<T>(f(e.element(index.begin(), end)));
+                }
+            }
+        }
+    }
+
     /**
      * Save image to disk.
      * The desired image format is deduced from ``filename``.
@@ -114,6 +490,12 @@ namespace xvigra
      * Most common formats are supported (jpg, png, gif, bmp, tiff).
      * The shape of the array must be ``HEIGHT x WIDTH`` or ``HEIGHT x WIDTH x CHANNELS``.
      *
+     * The data are written scanline by scanline, so ``data`` may be an unevaluated
+     * expression and no temporary copy of the whole image is created. When the file
+     * format doesn't support the value_type (and ``options.autoconvert`` is set),
+     * the min/max of ``data`` are determined in a first pass, and each scanline is
+     * normalized to the range 0...1 on the fly.
+     *
      * @param filename The path to the desired file
      * @param data Image data
      * @param options Pass a write_image_options object to fine-tune image export
@@ -124,6 +506,7 @@ namespace xvigra
     {
         E const & e = data.derived_cast();
         using value_type = typename std::decay_t<E>::value_type;
+        using real_t = real_promote_type_t<value_type>;
 
         auto shape = e.shape();
         vigra_precondition(shape.size() == 2 || shape.size() == 3,
@@ -147,31 +530,45 @@ namespace xvigra
                            : static_cast<int>(shape[2]);
         spec.format    = OIIO::BaseTypeFromC<value_type>::value;
 
-        out->open(filename, spec);
+        vigra_precondition(out->open(filename, spec),
+            "write_image(): " + out->geterror());
+
+        index_t const height   = spec.height,
+                      width    = spec.width,
+                      channels = spec.nchannels;
+
+        auto write_rows = [&](auto * buffer, auto f)
+        {
+            using buffer_type = std::remove_pointer_t<decltype(buffer)>;
+            for(index_t y = 0; y < height; ++y)
+            {
+                detail::write_image_row(e, y, width, channels, buffer, f);
+                vigra_precondition(out->write_scanline(static_cast<int>(y), 0,
+                                           OIIO::BaseTypeFromC<buffer_type>::value, buffer),
+                    "write_image(): " + out->geterror());
+            }
+        };
 
-        auto && ex = xt::eval(e);
-        if(out->spec().format != OIIO::BaseTypeFromC<value_type>::value)
+        if(options.autoconvert && out->spec().format != OIIO::BaseTypeFromC<value_type>::value)
         {
             // OpenImageIO changed the target type because the file format doesn't support value_type.
             // It will do automatic conversion, but the data should be in the range 0...1
             // for good results.
-            auto mM = minmax(ex)();
+            auto mM = minmax(e)();
 
             if(mM[0] != mM[1])
             {
-                using real_t = real_promote_type_t<value_type>;
-                auto && normalized = xt::eval((real_t(1.0) / (mM[1] - mM[0])) * (ex - mM[0]));
-                out->write_image(OIIO::BaseTypeFromC<real_t>::value, normalized.raw_data());
+                real_t offset = static_cast<real_t>(mM[0]),
+                       scale  = real_t(1.0) / static_cast<real_t>(mM[1] - mM[0]);
+                std::unique_ptr<real_t[]> buffer(new real_t[width*channels]);
+                write_rows(buffer.get(),
+                           [offset, scale](value_type v) { return scale * (static_cast<real_t>(v) - offset); });
+                return;
             }
-            else
-            {
-                out->write_image(OIIO::BaseTypeFromC<value_type>::value, ex.raw_data());
-            }
-        }
-        else
-        {
-            out->write_image(OIIO::BaseTypeFromC<value_type>::value, ex.raw_data());
         }
+
+        std::unique_ptr<value_type[]> buffer(new value_type[width*channels]);
+        write_rows(buffer.get(), [](value_type v) { return v; });
     }
 }
 
@@ -0,0 +1,317 @@
+/************************************************************************/
+/*                                                                      */
+/*     Copyright 2017-2018 by Ullrich Koethe                            */
+/*                                                                      */
+/*    This file is part of the XVIGRA image analysis library.           */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+
+#ifndef XVIGRA_INSTRUMENTATION_HPP
+#define XVIGRA_INSTRUMENTATION_HPP
+
+#include <chrono>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "global.hpp"
+
+/*
+    Opt-in performance counters for xvigra's algorithms.
+
+    When XVIGRA_ENABLE_INSTRUMENTATION is defined (CMake option ENABLE_INSTRUMENTATION),
+    every call of a functor (e.g. separable_convolution, distance_transform_squared)
+    records the number of elements processed, the bytes read and written, the
+    temporary arrays allocated, and the wall time, accumulated per functor name.
+    The ratio of bytes to time and elements to time tells whether an algorithm
+    runs close to the memory bandwidth of the machine or is compute-bound:
+
+        separable_convolution_functor()(in, out, kernel);
+        instrumentation::report(std::cout);      // human readable table
+        instrumentation::report_json(file);      // for further processing
+
+    Otherwise, the XVIGRA_INSTRUMENT_* macros expand to nothing and there is no
+    runtime cost.
+*/
+
+namespace xvigra
+{
+namespace instrumentation
+{
+    /************/
+    /* counters */
+    /************/
+
+    struct counters
+    {
+        index_t calls = 0;
+        index_t pixels = 0;            // array elements processed
+        index_t bytes_read = 0;
+        index_t bytes_written = 0;
+        index_t temporaries = 0;       // number of temporary arrays allocated
+        index_t temporary_bytes = 0;
+        double seconds = 0.0;
+
+        counters & operator+=(counters const & o)
+        {
+            calls           += o.calls;
+            pixels          += o.pixels;
+            bytes_read      += o.bytes_read;
+            bytes_written   += o.bytes_written;
+            temporaries     += o.temporaries;
+            temporary_bytes += o.temporary_bytes;
+            seconds         += o.seconds;
+            return *this;
+        }
+
+        double mpix_per_second() const
+        {
+            return seconds > 0.0 ? 1e-6*pixels / seconds : 0.0;
+        }
+
+        double gb_per_second() const
+        {
+            return seconds > 0.0 ? 1e-9*(bytes_read + bytes_written) / seconds : 0.0;
+        }
+    };
+
+    /************/
+    /* registry */
+    /************/
+
+        // thread-safe accumulation of counters per algorithm name
+    class registry
+    {
+      public:
+        static registry & global()
+        {
+            static registry r;
+            return r;
+        }
+
+        void add(std::string const & name, counters const & c)
+        {
+            std::lock_guard<std::mutex> guard(lock_);
+            records_[name] += c;
+        }
+
+        std::map<std::string, counters> snapshot() const
+        {
+            std::lock_guard<std::mutex> guard(lock_);
+            return records_;
+        }
+
+        void reset()
+        {
+            std::lock_guard<std::mutex> guard(lock_);
+            records_.clear();
+        }
+
+      private:
+        mutable std::mutex lock_;
+        std::map<std::string, counters> records_;
+    };
+
+    /*********/
+    /* scope */
+    /*********/
+
+        /** Measure one algorithm invocation (RAII).
+
+            The counters are added to the global registry when the scope ends.
+            Scopes nest: temporaries are attributed to the innermost active scope.
+            A scope with the same name as the enclosing one is inactive, so that
+            recursive calls of a functor are counted only once.
+        */
+    class scope
+    {
+      public:
+        explicit
+        scope(std::string name)
+        : name_(std::move(name))
+        , parent_(current())
+        , active_(parent_ == nullptr || parent_->name_ != name_)
+        , start_(std::chrono::steady_clock::now())
+        {
+            if(active_)
+            {
+                counters_.calls = 1;
+                current() = this;
+            }
+        }
+
+        ~scope()
+        {
+            if(active_)
+            {
+                counters_.seconds = std::chrono::duration<double>(
+                                         std::chrono::steady_clock::now() - start_).count();
+                current() = parent_;
+                registry::global().add(name_, counters_);
+            }
+        }
+
+        scope(scope const &) = delete;
+        scope & operator=(scope const &) = delete;
+
+        void add_io(index_t pixels, index_t bytes_read, index_t bytes_written)
+        {
+            if(active_)
+            {
+                counters_.pixels        += pixels;
+                counters_.bytes_read    += bytes_read;
+                counters_.bytes_written += bytes_written;
+            }
+        }
+
+        void add_temporary(index_t bytes)
+        {
+            counters_.temporaries     += 1;
+            counters_.temporary_bytes += bytes;
+        }
+
+            // innermost active scope of the calling thread
+        static scope *& current()
+        {
+            static thread_local scope * s = nullptr;
+            return s;
+        }
+
+      private:
+        std::string name_;
+        scope * parent_;
+        bool active_;
+        std::chrono::steady_clock::time_point start_;
+        counters counters_;
+    };
+
+        // record the allocation of a temporary array in the innermost scope
+    inline void add_temporary(index_t bytes)
+    {
+        if(scope * s = scope::current())
+            s->add_temporary(bytes);
+    }
+
+        // record the temporary created by 'eval_expr()' when 'E' is an unevaluated expression
+    template <class E, class A>
+    void add_eval_temporary(A const & a)
+    {
+        if(!std::is_same<std::decay_t<E>, std::decay_t<A>>::value)
+            add_temporary(a.size()*sizeof(typename std::decay_t<A>::value_type));
+    }
+
+    /**********/
+    /* report */
+    /**********/
+
+    inline void reset()
+    {
+        registry::global().reset();
+    }
+
+        // print the accumulated counters as a table
+    inline void report(std::ostream & out)
+    {
+        auto flags = out.flags();
+        auto precision = out.precision();
+        out << std::left << std::setw(32) << "algorithm" << std::right
+            << std::setw(8)  << "calls"
+            << std::setw(12) << "MPix"
+            << std::setw(12) << "MB read"
+            << std::setw(12) << "MB written"
+            << std::setw(8)  << "temps"
+            << std::setw(12) << "temp MB"
+            << std::setw(12) << "seconds"
+            << std::setw(10) << "MPix/s"
+            << std::setw(10) << "GB/s" << "\n";
+        out << std::fixed << std::setprecision(3);
+        for(auto const & r: registry::global().snapshot())
+        {
+            counters const & c = r.second;
+            out << std::left << std::setw(32) << r.first << std::right
+                << std::setw(8)  << c.calls
+                << std::setw(12) << 1e-6*c.pixels
+                << std::setw(12) << 1e-6*c.bytes_read
+                << std::setw(12) << 1e-6*c.bytes_written
+                << std::setw(8)  << c.temporaries
+                << std::setw(12) << 1e-6*c.temporary_bytes
+                << std::setw(12) << c.seconds
+                << std::setw(10) << c.mpix_per_second()
+                << std::setw(10) << c.gb_per_second() << "\n";
+        }
+        out.flags(flags);
+        out.precision(precision);
+    }
+
+        // export the accumulated counters as a JSON object keyed by algorithm name
+    inline void report_json(std::ostream & out)
+    {
+        auto precision = out.precision(9);
+        out << "{";
+        bool first = true;
+        for(auto const & r: registry::global().snapshot())
+        {
+            counters const & c = r.second;
+            out << (first ? "\n" : ",\n")
+                << "  \"" << r.first << "\": {"
+                << "\"calls\": " << c.calls
+                << ", \"pixels\": " << c.pixels
+                << ", \"bytes_read\": " << c.bytes_read
+                << ", \"bytes_written\": " << c.bytes_written
+                << ", \"temporaries\": " << c.temporaries
+                << ", \"temporary_bytes\": " << c.temporary_bytes
+                << ", \"seconds\": " << c.seconds
+                << ", \"mpix_per_second\": " << c.mpix_per_second()
+                << ", \"gb_per_second\": " << c.gb_per_second() << "}";
+            first = false;
+        }
+        out << "\n}\n";
+        out.precision(precision);
+    }
+
+} // namespace instrumentation
+} // namespace xvigra
+
+#ifdef XVIGRA_ENABLE_INSTRUMENTATION
+    #define XVIGRA_INSTRUMENT_SCOPE(NAME) \
+        ::xvigra::instrumentation::scope xvigra_instrumentation_scope_(NAME)
+    #define XVIGRA_INSTRUMENT_IO(PIXELS, BYTES_READ, BYTES_WRITTEN) \
+        xvigra_instrumentation_scope_.add_io(PIXELS, BYTES_READ, BYTES_WRITTEN)
+    #define XVIGRA_INSTRUMENT_TEMPORARY(BYTES) \
+        ::xvigra::instrumentation::add_temporary(BYTES)
+    #define XVIGRA_INSTRUMENT_EVAL(E, A) \
+        ::xvigra::instrumentation::add_eval_temporary<E>(A)
+#else
+    #define XVIGRA_INSTRUMENT_SCOPE(NAME)
+    #define XVIGRA_INSTRUMENT_IO(PIXELS, BYTES_READ, BYTES_WRITTEN)
+    #define XVIGRA_INSTRUMENT_TEMPORARY(BYTES)
+    #define XVIGRA_INSTRUMENT_EVAL(E, A)
+#endif
+
+#endif // XVIGRA_INSTRUMENTATION_HPP
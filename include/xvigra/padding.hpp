@@ -32,9 +32,13 @@
 #define XVIGRA_PADDING_HPP
 
 #include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
 #include "global.hpp"
 #include "concepts.hpp"
 #include "error.hpp"
+#include "array_nd.hpp"
 
 namespace xvigra
 {
@@ -48,152 +52,607 @@ namespace xvigra
         reflect0_padding
     };
 
+    namespace detail
+    {
+            // check the requirements of copy_with_padding() documented below
+        inline void check_padding_sizes(index_t size,
+                                        padding_mode left_padding_mode, index_t left_padding_size,
+                                        padding_mode right_padding_mode, index_t right_padding_size)
+        {
+            for(int side=0; side<2; ++side)
+            {
+                padding_mode mode = side == 0 ? left_padding_mode : right_padding_mode;
+                index_t padding_size = side == 0 ? left_padding_size : right_padding_size;
+                std::string name = side == 0 ? "left" : "right";
+                switch(mode)
+                {
+                    case zero_padding:
+                        break;
+                    case repeat_padding:
+                        vigra_precondition(size > 0,
+                            "copy_with_padding(): input size must be non-zero.");
+                        break;
+                    case periodic_padding:
+                    case reflect_padding:
+                    case reflect0_padding:
+                        vigra_precondition(padding_size < size,
+                            "copy_with_padding(): " + name + "_padding_size must be less than input size.");
+                        break;
+                    case no_padding:
+                        break;
+                    default:
+                        vigra_fail("copy_with_padding(): illegal " + name + "_padding_mode.");
+                }
+            }
+        }
+
+            // element-wise copy for arbitrary 1D arrays
+        template <class InArray, class OutArray>
+        void copy_with_padding_impl(std::false_type, InArray const & in, OutArray && out,
+                                    padding_mode left_padding_mode, index_t left_padding_size,
+                                    padding_mode right_padding_mode, index_t right_padding_size)
+        {
+            using dest_type =  typename std::decay_t<OutArray>::value_type;
+
+            index_t size = in.size();
+
+            for(index_t k=0; k<(index_t)in.shape()[0]; ++k)
+            {
+                out(k+left_padding_size) = in(k);
+            }
+
+            switch(left_padding_mode)
+            {
+                case zero_padding:
+                {
+                    for(index_t k=0; k<left_padding_size; ++k)
+                    {
+                        out(k) = dest_type();
+                    }
+                    break;
+                }
+                case repeat_padding:
+                {
+                    for(index_t k=0; k<left_padding_size; ++k)
+                    {
+                        out(k) = conditional_cast<std::is_arithmetic<dest_type>::value, dest_type>(in(0));
+                    }
+                    break;
+                }
+                case periodic_padding:
+                {
+                    index_t offset = size-left_padding_size;
+                    for(index_t k=0; k < left_padding_size; ++k)
+                    {
+                        out(k) = conditional_cast<std::is_arithmetic<dest_type>::value, dest_type>(in(offset+k));
+                    }
+                    break;
+                }
+                case reflect_padding:
+                case reflect0_padding:
+                {
+                    index_t offset = left_padding_size;
+                    if(left_padding_mode == reflect0_padding)
+                    {
+                        offset -= 1;
+                    }
+                    for(index_t k=0; k < left_padding_size; ++k)
+                    {
+                        out(k) = conditional_cast<std::is_arithmetic<dest_type>::value, dest_type>(in(offset-k));
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+
+            switch(right_padding_mode)
+            {
+                case zero_padding:
+                {
+                    for(index_t k=size+left_padding_size; k<(index_t)out.shape()[0]; ++k)
+                    {
+                        out(k) = dest_type();
+                    }
+                    break;
+                }
+                case repeat_padding:
+                {
+                    for(index_t k=size+left_padding_size; k<(index_t)out.shape()[0]; ++k)
+                    {
+                        out(k) = conditional_cast<std::is_arithmetic<dest_type>::value, dest_type>(in(size-1));
+                    }
+                    break;
+                }
+                case periodic_padding:
+                {
+                    index_t offset = size + left_padding_size;
+                    for(index_t k=0; k < right_padding_size; ++k)
+                    {
+                        out(offset+k) = conditional_cast<std::is_arithmetic<dest_type>::value, dest_type>(in(k));
+                    }
+                    break;
+                }
+                case reflect_padding:
+                case reflect0_padding:
+                {
+                    index_t in_offset  = size - 1,
+                            out_offset = size + left_padding_size;
+                    if(right_padding_mode == reflect_padding)
+                    {
+                        in_offset -= 1;
+                    }
+                    for(index_t k=0; k < right_padding_size; ++k)
+                    {
+                        out(out_offset+k) = conditional_cast<std::is_arithmetic<dest_type>::value, dest_type>(in(in_offset-k));
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+
+            // contiguous views of the same trivially copyable type: copy blocks of memory
+        template <class InArray, class OutArray>
+        void copy_with_padding_impl(std::true_type, InArray const & in, OutArray && out,
+                                    padding_mode left_padding_mode, index_t left_padding_size,
+                                    padding_mode right_padding_mode, index_t right_padding_size)
+        {
+            if(in.strides(0) != 1 || out.strides(0) != 1)
+            {
+                copy_with_padding_impl(std::false_type(), in, std::forward<OutArray>(out),
+                                       left_padding_mode, left_padding_size,
+                                       right_padding_mode, right_padding_size);
+                return;
+            }
+
+            using value_type = typename std::decay_t<OutArray>::value_type;
+
+            index_t size = in.size();
+            // memmove() also supports in-place padding, where 'in' is the interior of 'out'
+            value_type * interior = out.raw_data() + left_padding_size,
+                       * end      = interior + size;
+            std::memmove(interior, in.raw_data(), size*sizeof(value_type));
+
+            switch(left_padding_mode)
+            {
+                case zero_padding:
+                    std::fill(out.raw_data(), interior, value_type());
+                    break;
+                case repeat_padding:
+                    std::fill(out.raw_data(), interior, interior[0]);
+                    break;
+                case periodic_padding:
+                    std::copy(end - left_padding_size, end, out.raw_data());
+                    break;
+                case reflect_padding:
+                    std::reverse_copy(interior + 1, interior + 1 + left_padding_size, out.raw_data());
+                    break;
+                case reflect0_padding:
+                    std::reverse_copy(interior, interior + left_padding_size, out.raw_data());
+                    break;
+                default:
+                    break;
+            }
+
+            switch(right_padding_mode)
+            {
+                case zero_padding:
+                    std::fill(end, end + right_padding_size, value_type());
+                    break;
+                case repeat_padding:
+                    std::fill(end, end + right_padding_size, end[-1]);
+                    break;
+                case periodic_padding:
+                    std::copy(interior, interior + right_padding_size, end);
+                    break;
+                case reflect_padding:
+                    std::reverse_copy(end - 1 - right_padding_size, end - 1, end);
+                    break;
+                case reflect0_padding:
+                    std::reverse_copy(end - right_padding_size, end, end);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
     // 'in' and 'out' must be 1-dimensional arrays whose sizes fulfill:
     // 'left_padding_size + in.size() + right_padding_size == out.size()'
     // For padding modes periodic_padding, reflect_padding, reflect0_padding:
     // 'left_padding_size < in.size() && right_padding_size < in.size()'
-    // For padding mode no_padding:
-    // 'left_padding_size == 0 && right_padding_size == 0'
+    // For padding mode no_padding, the corresponding border of 'out' is left unchanged.
+    //
+    // Contiguous view_nd's of the same trivially copyable element type
+    // are copied with memmove() and std::copy() instead of element-wise.
     template <class InArray, class OutArray,
               VIGRA_REQUIRE<tensor_concept<InArray>::value && tensor_concept<OutArray>::value>>
     void copy_with_padding(InArray const & in, OutArray && out,
                            padding_mode left_padding_mode, index_t left_padding_size,
                            padding_mode right_padding_mode, index_t right_padding_size)
     {
-        using dest_type =  typename std::decay_t<OutArray>::value_type;
+        using source_type = std::remove_const_t<typename InArray::value_type>;
+        using dest_type   = typename std::decay_t<OutArray>::value_type;
+        using fast_path = std::integral_constant<bool,
+                              view_nd_concept<InArray>::value && view_nd_concept<OutArray>::value &&
+                              std::is_same<source_type, dest_type>::value &&
+                              std::is_trivially_copyable<dest_type>::value>;
 
         index_t size = in.size();
         vigra_precondition(left_padding_size + size + right_padding_size == (index_t)out.size(),
             "copy_with_padding(): output size must equal input size plus padding sizes.");
+        detail::check_padding_sizes(size, left_padding_mode, left_padding_size,
+                                    right_padding_mode, right_padding_size);
 
-        for(index_t k=0; k<(index_t)in.shape()[0]; ++k)
-        {
-            out(k+left_padding_size) = in(k);
-        }
+        detail::copy_with_padding_impl(fast_path(), in, std::forward<OutArray>(out),
+                                       left_padding_mode, left_padding_size,
+                                       right_padding_mode, right_padding_size);
+    }
 
-        switch(left_padding_mode)
+    template <class InArray, class OutArray,
+              VIGRA_REQUIRE<tensor_concept<InArray>::value && tensor_concept<OutArray>::value>>
+    void copy_with_padding(InArray const & in, OutArray && out,
+                           padding_mode pad_mode, index_t pad_size)
+    {
+        copy_with_padding(in, std::forward<OutArray>(out), pad_mode, pad_size, pad_mode, pad_size);
+    }
+
+    /*******/
+    /* pad */
+    /*******/
+
+    namespace detail
+    {
+            // advance 'index' to the next point of the box [begin, end) in scan order,
+            // considering only the first 'ndim' axes
+        template <class SHAPE>
+        inline bool next_scan_index(SHAPE & index, SHAPE const & begin, SHAPE const & end, index_t ndim)
         {
-            case zero_padding:
+            for(index_t d=ndim-1; d>=0; --d)
             {
-                for(index_t k=0; k<left_padding_size; ++k)
+                if(++index[d] < end[d])
                 {
-                    out(k) = dest_type();
+                    return true;
                 }
-                break;
+                index[d] = begin[d];
             }
-            case repeat_padding:
-            {
-                vigra_precondition(size > 0,
-                    "copy_with_padding(): input size must be non-zero.");
+            return false;
+        }
 
-                for(index_t k=0; k<left_padding_size; ++k)
-                {
-                    out(k) = conditional_cast<std::is_arithmetic<dest_type>::value, dest_type>(in(0));
-                }
-                break;
+            // padding mode of axis 'd' (a single mode applies to all axes)
+        inline padding_mode padding_mode_of_axis(tiny_vector<padding_mode> const & modes, index_t d)
+        {
+            vigra_precondition(modes.size() == 1 || d < (index_t)modes.size(),
+                "pad(): need a single padding mode or one per axis.");
+            return modes.size() == 1 ? modes[0] : modes[d];
+        }
+
+            // map coordinate 'i' of an axis of length 'size' to the coordinate it is
+            // copied from (the same as in copy_with_padding()), or -1 for zero padding
+        inline index_t padding_source_index(index_t i, index_t size,
+                                            padding_mode left_mode, padding_mode right_mode)
+        {
+            if(0 <= i && i < size)
+            {
+                return i;
             }
-            case periodic_padding:
+            padding_mode mode = i < 0 ? left_mode : right_mode;
+            index_t overhang  = i < 0 ? -i : i - size + 1;
+            switch(mode)
             {
-                vigra_precondition(left_padding_size < size,
-                    "copy_with_padding(): left_padding_size must be less than input size.");
-
-                index_t offset = size-left_padding_size;
-                for(index_t k=0; k < left_padding_size; ++k)
-                {
-                    out(k) = conditional_cast<std::is_arithmetic<dest_type>::value, dest_type>(in(offset+k));
-                }
-                break;
+                case zero_padding:
+                    return -1;
+                case repeat_padding:
+                    vigra_precondition(size > 0,
+                        "pad(): input size must be non-zero.");
+                    return i < 0 ? 0 : size - 1;
+                case periodic_padding:
+                case reflect_padding:
+                case reflect0_padding:
+                    vigra_precondition(overhang < size,
+                        "pad(): padding width must be less than input size.");
+                    if(mode == periodic_padding)
+                    {
+                        return i < 0 ? i + size : i - size;
+                    }
+                    if(mode == reflect_padding)
+                    {
+                        return i < 0 ? -i : 2*size - 2 - i;
+                    }
+                    return i < 0 ? -i - 1 : 2*size - 1 - i;
+                default:
+                    vigra_fail("pad(): points outside of the input require a padding mode.");
             }
-            case reflect_padding:
-            case reflect0_padding:
+            return -1;
+        }
+
+        template <class T1, class T2>
+        inline void copy_padding_row(std::false_type, T1 const * src, index_t ss,
+                                     index_t size, T2 * dest, index_t ds)
+        {
+            for(index_t k=0; k<size; ++k)
             {
-                vigra_precondition(left_padding_size < size,
-                    "copy_with_padding(): left_padding_size must be less than input size.");
+                dest[k*ds] = conditional_cast<std::is_arithmetic<T2>::value, T2>(src[k*ss]);
+            }
+        }
 
-                index_t offset = left_padding_size;
-                if(left_padding_mode == reflect0_padding)
-                {
-                    offset -= 1;
-                }
-                for(index_t k=0; k < left_padding_size; ++k)
-                {
-                    out(k) = conditional_cast<std::is_arithmetic<dest_type>::value, dest_type>(in(offset-k));
-                }
-                break;
+        template <class T>
+        inline void copy_padding_row(std::true_type, T const * src, index_t ss,
+                                     index_t size, T * dest, index_t ds)
+        {
+            if(ss == 1 && ds == 1)
+            {
+                std::memmove(dest, src, size*sizeof(T));
             }
-            default:
+            else
             {
-                vigra_precondition(left_padding_mode == no_padding,
-                    "copy_with_padding(): illegal left_padding_mode.");
+                copy_padding_row(std::false_type(), src, ss, size, dest, ds);
             }
         }
 
-        switch(right_padding_mode)
+            // Set 'out[p] = in[origin + p]', where coordinates outside of 'in' are
+            // mapped according to the padding modes. Every output point is written
+            // once, and the interior of each output row is copied as a block.
+        template <class T1, index_t N1, class T2, index_t N2>
+        void copy_box_with_padding(view_nd<T1, N1> const & in, view_nd<T2, N2> out,
+                                   shape_t<N1> const & origin,
+                                   tiny_vector<padding_mode> const & left_modes,
+                                   tiny_vector<padding_mode> const & right_modes)
         {
-            case zero_padding:
+            using source_type = std::remove_const_t<T1>;
+            using dest_type   = std::remove_const_t<T2>;
+            using fast_copy = std::integral_constant<bool,
+                                  std::is_same<source_type, dest_type>::value &&
+                                  std::is_trivially_copyable<dest_type>::value>;
+
+            index_t N    = in.dimension(),
+                    last = N - 1;
+            vigra_precondition((index_t)out.dimension() == N && (index_t)origin.size() == N,
+                "pad(): dimension mismatch.");
+            for(index_t d=0; d<N; ++d)
             {
-                for(index_t k=size+left_padding_size; k<(index_t)out.shape()[0]; ++k)
+                if(out.shape(d) == 0)
                 {
-                    out(k) = dest_type();
+                    return; // empty output
                 }
-                break;
             }
-            case repeat_padding:
-            {
-                vigra_precondition(size > 0,
-                    "copy_with_padding(): input size must be non-zero.");
 
-                for(index_t k=size+left_padding_size; k<(index_t)out.shape()[0]; ++k)
+            // the source coordinate of every output coordinate, separately for each axis
+            std::vector<std::vector<index_t>> source(N);
+            for(index_t d=0; d<N; ++d)
+            {
+                padding_mode left_mode  = padding_mode_of_axis(left_modes, d),
+                             right_mode = padding_mode_of_axis(right_modes, d);
+                source[d].resize(out.shape(d));
+                for(index_t p=0; p<out.shape(d); ++p)
                 {
-                    out(k) = conditional_cast<std::is_arithmetic<dest_type>::value, dest_type>(in(size-1));
+                    source[d][p] = padding_source_index(origin[d] + p, in.shape(d), left_mode, right_mode);
                 }
-                break;
             }
-            case periodic_padding:
-            {
-                vigra_precondition(right_padding_size < size,
-                    "copy_with_padding(): right_padding_size must be less than input size.");
 
-                index_t offset = size + left_padding_size;
-                for(index_t k=0; k < right_padding_size; ++k)
+            // output points [begin, end) of each row are inside of 'in'
+            index_t width = out.shape(last),
+                    begin = std::min(width, std::max<index_t>(0, -origin[last])),
+                    end   = std::max(begin, std::min(width, in.shape(last) - origin[last])),
+                    ss    = in.strides(last),
+                    ds    = out.strides(last);
+
+            shape_t<N1> index(N, 0), zero(N, 0), shape(out.shape());
+            do
+            {
+                source_type const * src = in.raw_data();
+                dest_type * dest = out.raw_data() + dot(out.strides(), index);
+                bool zero_row = false;
+                for(index_t d=0; d<last; ++d)
+                {
+                    index_t s = source[d][index[d]];
+                    if(s < 0)
+                    {
+                        zero_row = true;
+                        break;
+                    }
+                    src += s*in.strides(d);
+                }
+                for(index_t p=0; p<width; ++p)
                 {
-                    out(offset+k) = conditional_cast<std::is_arithmetic<dest_type>::value, dest_type>(in(k));
+                    if(p == begin && begin < end && !zero_row)
+                    {
+                        copy_padding_row(fast_copy(), src + source[last][p]*ss, ss,
+                                         end - begin, dest + p*ds, ds);
+                        p = end - 1;
+                        continue;
+                    }
+                    index_t s = zero_row ? -1 : source[last][p];
+                    if(s < 0)
+                    {
+                        dest[p*ds] = dest_type();
+                    }
+                    else
+                    {
+                        dest[p*ds] = conditional_cast<std::is_arithmetic<dest_type>::value, dest_type>(src[s*ss]);
+                    }
                 }
-                break;
             }
-            case reflect_padding:
-            case reflect0_padding:
+            while(next_scan_index(index, zero, shape, last));
+        }
+    }
+
+        // Copy 'in' into 'out' such that 'in' starts at 'left_width', and fill the
+        // remaining points according to the padding modes (one per axis, or a single
+        // mode for all axes) as in copy_with_padding(). This needs a single pass
+        // over 'out', where the interior of every row is copied as a block.
+    template <class T1, index_t N1, class T2, index_t N2>
+    void pad(view_nd<T1, N1> const & in, view_nd<T2, N2> out,
+             shape_t<N1> const & left_width,
+             tiny_vector<padding_mode> const & left_modes,
+             tiny_vector<padding_mode> const & right_modes)
+    {
+        vigra_precondition(in.dimension() == out.dimension(),
+            "pad(): dimension mismatch between input and output.");
+        for(index_t d=0; d<(index_t)in.dimension(); ++d)
+        {
+            vigra_precondition(0 <= left_width[d] && left_width[d] + in.shape(d) <= out.shape(d),
+                "pad(): output shape must equal input shape plus padding widths.");
+        }
+        detail::copy_box_with_padding(in, out, shape_t<N1>(-left_width), left_modes, right_modes);
+    }
+
+        // allocate and return the padded array
+    template <class T, index_t N>
+    array_nd<std::remove_const_t<T>, N>
+    pad(view_nd<T, N> const & in,
+        shape_t<N> const & left_width, shape_t<N> const & right_width,
+        tiny_vector<padding_mode> const & left_modes,
+        tiny_vector<padding_mode> const & right_modes)
+    {
+        array_nd<std::remove_const_t<T>, N> res(shape_t<N>(in.shape() + left_width + right_width));
+        pad(in, res, left_width, left_modes, right_modes);
+        return res;
+    }
+
+    template <class T, index_t N>
+    array_nd<std::remove_const_t<T>, N>
+    pad(view_nd<T, N> const & in, shape_t<N> const & width, padding_mode mode)
+    {
+        return pad(in, width, width, tiny_vector<padding_mode>{mode}, tiny_vector<padding_mode>{mode});
+    }
+
+        // Halo extraction for tiled processing: copy the tile of 'in' starting at
+        // 'tile_begin', extended by 'halo' points on the left of each axis, into
+        // 'out' (whose shape determines the tile size plus both halos). Halo
+        // points inside of 'in' are taken from the neighboring tiles, the others
+        // are filled according to the padding modes.
+    template <class T1, index_t N1, class T2, index_t N2>
+    void copy_with_halo(view_nd<T1, N1> const & in, view_nd<T2, N2> out,
+                        shape_t<N1> const & tile_begin, shape_t<N1> const & halo,
+                        tiny_vector<padding_mode> const & left_modes,
+                        tiny_vector<padding_mode> const & right_modes)
+    {
+        vigra_precondition(in.dimension() == out.dimension(),
+            "copy_with_halo(): dimension mismatch between input and output.");
+        detail::copy_box_with_padding(in, out, shape_t<N1>(tile_begin - halo), left_modes, right_modes);
+    }
+
+    /***************/
+    /* padded_view */
+    /***************/
+
+        // Read-only access to a view_nd, where indices outside of the view are
+        // mapped according to the padding modes (as in copy_with_padding()),
+        // so that borders need not be copied into a padded buffer.
+        //
+        // regions() splits the view into the interior, where a neighborhood of
+        // the given extent is completely inside of the data (so that it can be
+        // processed via data() without any index checks), and the border slabs,
+        // where operator[] handles the padding.
+    template <class T, index_t N = runtime_size>
+    class padded_view
+    {
+      public:
+        using value_type = std::remove_const_t<T>;
+        using shape_type = shape_t<N>;
+        using modes_type = tiny_vector<padding_mode, N>;
+
+            // a box [begin, end) of points which are either all
+            // in the interior or all in the border
+        struct region
+        {
+            shape_type begin, end;
+            bool border;
+        };
+
+        padded_view(view_nd<T, N> const & data,
+                    tiny_vector<padding_mode> const & left_modes,
+                    tiny_vector<padding_mode> const & right_modes)
+        : data_(data),
+          left_modes_(data.dimension()),
+          right_modes_(data.dimension())
+        {
+            for(index_t d=0; d<(index_t)data.dimension(); ++d)
             {
-                vigra_precondition(right_padding_size < size,
-                    "copy_with_padding(): right_padding_size must be less than input size.");
+                left_modes_[d]  = detail::padding_mode_of_axis(left_modes, d);
+                right_modes_[d] = detail::padding_mode_of_axis(right_modes, d);
+            }
+        }
 
-                index_t in_offset  = size - 1,
-                        out_offset = size + left_padding_size;
-                if(right_padding_mode == reflect_padding)
-                {
-                    in_offset -= 1;
-                }
-                for(index_t k=0; k < right_padding_size; ++k)
+        padded_view(view_nd<T, N> const & data, padding_mode mode)
+        : padded_view(data, tiny_vector<padding_mode>{mode}, tiny_vector<padding_mode>{mode})
+        {}
+
+        view_nd<T, N> const & data() const
+        {
+            return data_;
+        }
+
+        shape_type const & shape() const
+        {
+            return data_.shape();
+        }
+
+        index_t dimension() const
+        {
+            return data_.dimension();
+        }
+
+            // value at an arbitrary point 'p'
+        value_type operator[](shape_type const & p) const
+        {
+            index_t offset = 0;
+            for(index_t d=0; d<(index_t)p.size(); ++d)
+            {
+                index_t i = p[d];
+                if(i < 0 || i >= data_.shape(d))
                 {
-                    out(out_offset+k) = conditional_cast<std::is_arithmetic<dest_type>::value, dest_type>(in(in_offset-k));
+                    i = detail::padding_source_index(i, data_.shape(d), left_modes_[d], right_modes_[d]);
+                    if(i < 0)
+                    {
+                        return value_type();
+                    }
                 }
-                break;
+                offset += i*data_.strides(d);
             }
-            default:
+            return data_.raw_data()[offset];
+        }
+
+            // Split the view into the interior box, where the neighborhood
+            // [p - left, p + right] of every point 'p' is inside of the data,
+            // and up to 2*N border slabs covering the remaining points.
+            // The interior (if non-empty) is always the first region.
+        std::vector<region> regions(shape_type const & left, shape_type const & right) const
+        {
+            index_t n = dimension();
+            shape_type ibegin(min(left, shape())),
+                       iend(max(ibegin, shape_type(shape() - right))),
+                       lo(n, 0), hi(shape());
+            std::vector<region> res, slabs;
+            for(index_t d=0; d<n; ++d)
             {
-                vigra_precondition(right_padding_mode == no_padding,
-                    "copy_with_padding(): illegal right_padding_mode.");
+                // slabs along axis 'd' span the interior range of the preceding axes
+                region l{lo, hi, true}, r{lo, hi, true};
+                l.end[d]   = ibegin[d];
+                r.begin[d] = iend[d];
+                slabs.push_back(l);
+                slabs.push_back(r);
+                lo[d] = ibegin[d];
+                hi[d] = iend[d];
+            }
+            slabs.insert(slabs.begin(), region{lo, hi, false});
+            for(auto const & s : slabs)
+            {
+                if(all_less(s.begin, s.end))
+                {
+                    res.push_back(s);
+                }
             }
+            return res;
         }
-    }
 
-    template <class InArray, class OutArray,
-              VIGRA_REQUIRE<tensor_concept<InArray>::value && tensor_concept<OutArray>::value>>
-    void copy_with_padding(InArray const & in, OutArray && out,
-                           padding_mode pad_mode, index_t pad_size)
-    {
-        copy_with_padding(in, std::forward<OutArray>(out), pad_mode, pad_size, pad_mode, pad_size);
-    }
+      private:
+        view_nd<T, N> data_;
+        modes_type left_modes_, right_modes_;
+    };
 }
 
 #endif // XVIGRA_PADDING_HPP
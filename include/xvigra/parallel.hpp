@@ -0,0 +1,182 @@
+/************************************************************************/
+/*                                                                      */
+/*     Copyright 2017-2018 by Ullrich Koethe                            */
+/*                                                                      */
+/*    This file is part of the XVIGRA image analysis library.           */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+
+#ifndef XVIGRA_PARALLEL_HPP
+#define XVIGRA_PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "global.hpp"
+#include "error.hpp"
+#include "array_nd.hpp"
+
+namespace xvigra
+{
+    /****************/
+    /* parallel_for */
+    /****************/
+
+        // number of threads used when 'thread_count' is not specified
+    inline index_t
+    default_thread_count()
+    {
+        return std::max<index_t>(1, (index_t)std::thread::hardware_concurrency());
+    }
+
+        /** Call <tt>f(begin, end)</tt> for disjoint chunks covering the
+            index range [0, size), using up to 'thread_count' threads
+            (<tt>thread_count <= 0</tt> means 'default_thread_count()').
+
+            The range is split into chunks of 'grain_size' indices (chosen
+            automatically when <tt>grain_size <= 0</tt>), and idle threads
+            grab the next unprocessed chunk from a shared atomic counter.
+            Thus, threads that finish early take over work from slower ones.
+            The calling thread participates in the computation. If 'f' throws,
+            the remaining chunks are skipped and the first exception is
+            rethrown after all threads have been joined.
+        */
+    template <class F>
+    void parallel_for(index_t size, F && f,
+                      index_t thread_count = 0, index_t grain_size = 0)
+    {
+        if(size <= 0)
+            return;
+        if(thread_count <= 0)
+            thread_count = default_thread_count();
+        if(grain_size <= 0)
+            grain_size = std::max<index_t>(1, size / (8*thread_count));
+
+        index_t chunk_count = (size + grain_size - 1) / grain_size;
+        thread_count = std::min(thread_count, chunk_count);
+        if(thread_count <= 1)
+        {
+            f(index_t(0), size);
+            return;
+        }
+
+        std::atomic<index_t> next_chunk(0);
+        std::exception_ptr   error;
+        std::mutex           error_lock;
+
+        auto worker = [&]()
+        {
+            try
+            {
+                for(index_t chunk = next_chunk++; chunk < chunk_count; chunk = next_chunk++)
+                {
+                    index_t begin = chunk*grain_size;
+                    f(begin, std::min(begin + grain_size, size));
+                }
+            }
+            catch(...)
+            {
+                std::lock_guard<std::mutex> guard(error_lock);
+                if(!error)
+                    error = std::current_exception();
+                next_chunk = chunk_count;
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(thread_count-1);
+        for(index_t k=1; k<thread_count; ++k)
+        {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for(auto & t: threads)
+        {
+            t.join();
+        }
+        if(error)
+            std::rethrow_exception(error);
+    }
+
+    /**********************/
+    /* parallel_for_lines */
+    /**********************/
+
+        /** Call <tt>f(line)</tt> for all 1D lines of 'v' along 'axis',
+            where 'line' is a <tt>view_nd<T, 1></tt>. The lines are distributed
+            over 'thread_count' threads by means of 'parallel_for()', so 'f'
+            must be safe to call concurrently for different lines.
+        */
+    template <class T, index_t N, class F>
+    void parallel_for_lines(view_nd<T, N> v, index_t axis, F && f,
+                            index_t thread_count = 0)
+    {
+        vigra_precondition(0 <= axis && axis < (index_t)v.dimension(),
+            "parallel_for_lines(): axis out of range.");
+        auto lines = v.lines(axis);
+        parallel_for(lines.size(),
+            [&](index_t begin, index_t end)
+            {
+                for(auto line = lines.subrange(begin, end); line.has_more(); ++line)
+                {
+                    f(*line);
+                }
+            },
+            thread_count);
+    }
+
+        /** Call <tt>f(line1, line2)</tt> for all pairs of corresponding 1D lines
+            of 'v1' and 'v2' along 'axis'. Both arrays must have the same shape.
+        */
+    template <class T1, index_t N1, class T2, index_t N2, class F>
+    void parallel_for_lines(view_nd<T1, N1> v1, view_nd<T2, N2> v2, index_t axis, F && f,
+                            index_t thread_count = 0)
+    {
+        vigra_precondition(v1.shape() == v2.shape(),
+            "parallel_for_lines(): shape mismatch between input arrays.");
+        vigra_precondition(0 <= axis && axis < (index_t)v1.dimension(),
+            "parallel_for_lines(): axis out of range.");
+        auto lines1 = v1.lines(axis);
+        auto lines2 = v2.lines(axis);
+        parallel_for(lines1.size(),
+            [&](index_t begin, index_t end)
+            {
+                auto line1 = lines1.subrange(begin, end);
+                auto line2 = lines2.subrange(begin, end);
+                for(; line1.has_more(); ++line1, ++line2)
+                {
+                    f(*line1, *line2);
+                }
+            },
+            thread_count);
+    }
+
+} // namespace xvigra
+
+#endif // XVIGRA_PARALLEL_HPP
@@ -0,0 +1,326 @@
+/************************************************************************/
+/*                                                                      */
+/*     Copyright 2017-2018 by Ullrich Koethe                            */
+/*                                                                      */
+/*    This file is part of the XVIGRA image analysis library.           */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+
+#ifndef XVIGRA_PLANAR_ARRAY_HPP
+#define XVIGRA_PLANAR_ARRAY_HPP
+
+#include <utility>
+#include "global.hpp"
+#include "concepts.hpp"
+#include "error.hpp"
+#include "tiny_vector.hpp"
+#include "array_nd.hpp"
+
+namespace xvigra
+{
+    /******************/
+    /* planar_view_nd */
+    /******************/
+
+        /** View to a multi-channel image with planar ("struct of arrays") storage.
+
+            The data are held in a single <tt>view_nd</tt> of dimension N+1
+            whose first axis is the channel axis, so that each channel is
+            a separate plane. When the planes are contiguous, every call to
+            <tt>channel(c)</tt> returns a contiguous <tt>view_nd<T, N></tt>
+            that algorithms can process at full SIMD width, in contrast to
+            the stride-C views that <tt>bind_channel()</tt> creates for
+            <tt>array_nd<tiny_vector<T, C>, N></tt>.
+
+            Per-pixel access gathers (<tt>operator[]</tt>) or scatters
+            (<tt>set_pixel()</tt>) the channel values as a <tt>tiny_vector<T, C></tt>.
+            The functors in <tt>functor_base.hpp</tt> and <tt>separable_convolution</tt>
+            accept planar views directly and process one plane after another.
+
+            <b>Usage:</b>
+            \code
+                planar_array_nd<float, 2, 3> rgb(shape_t<2>{h, w});
+                view_nd<float, 2> red = rgb.channel(0);    // contiguous
+                tiny_vector<float, 3> p = rgb[{y, x}];      // gathered
+                separable_convolution(rgb, res, gaussian_kernel(2.0));
+            \endcode
+        */
+    template <class T, index_t N = runtime_size, index_t C = runtime_size>
+    class planar_view_nd
+    : public tags::planar_view_nd_tag
+    {
+      public:
+        static const index_t planes_dimension = (N == runtime_size) ? runtime_size : N+1;
+
+        using value_type  = T;
+        using pixel_type  = tiny_vector<std::remove_const_t<T>, C>;
+        using view_type   = view_nd<T, N>;
+        using planes_type = view_nd<T, planes_dimension>;
+        using shape_type  = shape_t<N>;
+
+        planar_view_nd()
+        : planes_()
+        {}
+
+            /** Construct from a view whose first axis is the channel axis.
+             */
+        explicit
+        planar_view_nd(planes_type const & planes)
+        : planes_(planes)
+        {
+            vigra_precondition(planes.dimension() >= 2,
+                "planar_view_nd(): planes must have at least two dimensions.");
+            vigra_precondition(C == runtime_size || planes.shape(0) == C,
+                "planar_view_nd(): number of planes doesn't match the number of channels.");
+        }
+
+        index_t dimension() const
+        {
+            return planes_.dimension() - 1;
+        }
+
+        index_t channels() const
+        {
+            return planes_.shape(0);
+        }
+
+        shape_type shape() const
+        {
+            return planes_.shape().pop_front();
+        }
+
+        index_t shape(index_t d) const
+        {
+            return planes_.shape(d+1);
+        }
+
+        bool has_data() const
+        {
+            return planes_.has_data();
+        }
+
+        bool is_contiguous() const
+        {
+            return planes_.is_contiguous();
+        }
+
+            // the underlying view of dimension N+1 with the channels along axis 0
+        planes_type const & planes() const
+        {
+            return planes_;
+        }
+
+            // view of channel 'c'
+        view_type channel(index_t c) const
+        {
+            vigra_precondition(0 <= c && c < channels(),
+                "planar_view_nd::channel(): index out of range.");
+            return planes_.bind(0, c);
+        }
+
+            // gather the channel values of the pixel at 'p'
+        pixel_type operator[](shape_type const & p) const
+        {
+            T * data = pixel_pointer(p);
+            index_t stride = planes_.strides(0);
+            pixel_type res(channels(), dont_init);
+            for(index_t c=0; c<channels(); ++c)
+            {
+                res[c] = data[c*stride];
+            }
+            return res;
+        }
+
+            // scatter the channel values 'v' to the pixel at 'p'
+        template <class V, index_t M, class R>
+        void set_pixel(shape_type const & p, tiny_vector<V, M, R> const & v) const
+        {
+            vigra_precondition(v.size() == channels(),
+                "planar_view_nd::set_pixel(): size mismatch.");
+            T * data = pixel_pointer(p);
+            index_t stride = planes_.strides(0);
+            for(index_t c=0; c<channels(); ++c)
+            {
+                data[c*stride] = v[c];
+            }
+        }
+
+            /** Copy the data from an array with interleaved ("array of structs")
+                storage, i.e. an array with element type <tt>tiny_vector<U, C></tt>.
+             */
+        template <class U, index_t M>
+        void assign_interleaved(view_nd<tiny_vector<U, C>, M> const & v) const
+        {
+            static_assert(C != runtime_size,
+                "planar_view_nd::assign_interleaved(): number of channels must be fixed.");
+            vigra_precondition(v.shape() == shape(),
+                "planar_view_nd::assign_interleaved(): shape mismatch.");
+            for(index_t c=0; c<C; ++c)
+            {
+                channel(c) = v.bind_channel(c);
+            }
+        }
+
+            /** Create an array with interleaved ("array of structs") storage
+                from the planar data.
+             */
+        array_nd<pixel_type, N> interleaved() const
+        {
+            static_assert(C != runtime_size,
+                "planar_view_nd::interleaved(): number of channels must be fixed.");
+            array_nd<pixel_type, N> res(shape());
+            for(index_t c=0; c<C; ++c)
+            {
+                res.bind_channel(c) = channel(c);
+            }
+            return res;
+        }
+
+      protected:
+
+        T * pixel_pointer(shape_type const & p) const
+        {
+            vigra_precondition(p.size() == dimension(),
+                "planar_view_nd: pixel coordinate has wrong dimension.");
+            T * data = const_cast<T *>(planes_.raw_data());
+            for(index_t d=0; d<p.size(); ++d)
+            {
+                data += p[d]*planes_.strides(d+1);
+            }
+            return data;
+        }
+
+        void reset(planes_type planes)
+        {
+            planes_.swap(planes);
+        }
+
+        planes_type planes_;
+    };
+
+    /*******************/
+    /* planar_array_nd */
+    /*******************/
+
+        /** Multi-channel image with planar ("struct of arrays") storage.
+            Each channel is held in a separate contiguous plane.
+            See \ref planar_view_nd for the access functions.
+        */
+    template <class T, index_t N = runtime_size, index_t C = runtime_size>
+    class planar_array_nd
+    : public planar_view_nd<T, N, C>
+    {
+      public:
+        using base_type = planar_view_nd<T, N, C>;
+        using typename base_type::value_type;
+        using typename base_type::pixel_type;
+        using typename base_type::view_type;
+        using typename base_type::planes_type;
+        using typename base_type::shape_type;
+        using array_type = array_nd<T, base_type::planes_dimension>;
+
+        planar_array_nd()
+        : base_type()
+        , allocated_planes_()
+        {}
+
+            /** Construct with given spatial shape and number of channels
+                (which can be omitted when C is fixed).
+             */
+        explicit
+        planar_array_nd(shape_type const & shape,
+                        index_t channels = C,
+                        value_type const & init = value_type())
+        : base_type()
+        , allocated_planes_(shape.insert(0, channels), planes_axistags(shape.size()), init)
+        {
+            vigra_precondition(channels > 0 && (C == runtime_size || channels == C),
+                "planar_array_nd(): invalid number of channels.");
+            this->reset(planes_type(allocated_planes_));
+        }
+
+            /** Construct from an array with interleaved ("array of structs") storage.
+             */
+        template <class U, index_t M>
+        explicit
+        planar_array_nd(view_nd<tiny_vector<U, C>, M> const & interleaved)
+        : planar_array_nd(shape_type(interleaved.shape()), C)
+        {
+            this->assign_interleaved(interleaved);
+        }
+
+        planar_array_nd(planar_array_nd const & rhs)
+        : base_type()
+        , allocated_planes_(rhs.allocated_planes_)
+        {
+            this->reset(planes_type(allocated_planes_));
+        }
+
+        planar_array_nd(planar_array_nd && rhs)
+        : planar_array_nd()
+        {
+            swap(rhs);
+        }
+
+        planar_array_nd & operator=(planar_array_nd const & rhs)
+        {
+            if(this != &rhs)
+            {
+                planar_array_nd tmp(rhs);
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        planar_array_nd & operator=(planar_array_nd && rhs)
+        {
+            swap(rhs);
+            return *this;
+        }
+
+        void swap(planar_array_nd & rhs)
+        {
+            allocated_planes_.swap(rhs.allocated_planes_);
+            this->reset(planes_type(allocated_planes_));
+            rhs.reset(planes_type(rhs.allocated_planes_));
+        }
+
+      private:
+
+        static typename array_type::axistags_type
+        planes_axistags(index_t ndim)
+        {
+            typename array_type::axistags_type res(ndim+1, tags::axis_unknown);
+            res[0] = tags::axis_c;
+            return res;
+        }
+
+        array_type allocated_planes_;
+    };
+
+} // namespace xvigra
+
+#endif // XVIGRA_PLANAR_ARRAY_HPP
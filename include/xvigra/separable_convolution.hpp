@@ -32,6 +32,7 @@
 #define XVIGRA_SEPARABLE_CONVOLUTION_HPP
 
 #include <deque>
+#include <vector>
 
 #ifdef XVIGRA_USE_SIMD
 #  include <xsimd/xsimd.hpp>
@@ -41,7 +42,10 @@
 #include "slice.hpp"
 #include "array_nd.hpp"
 #include "functor_base.hpp"
+#include "instrumentation.hpp"
+#include "trace.hpp"
 #include "kernel.hpp"
+#include "simd_dispatch.hpp"
 
 namespace xvigra
 {
@@ -49,12 +53,29 @@ namespace xvigra
     /* convolution_options */
     /***********************/
 
+        // implementation selected by convolution(), see convolution.hpp
+    enum convolution_method
+    {
+        auto_convolution,   // choose the cheapest method according to a cost model
+        direct_convolution, // convolve in the spatial domain
+        fft_convolution     // multiply in the Fourier domain
+    };
+
     struct convolution_options
     {
         using padding_vec = tiny_vector<padding_mode>;
+        using stride_vec  = tiny_vector<index_t>;
 
         bool simd = true;
         padding_vec left_padding{reflect_padding}, right_padding{reflect_padding};
+            // only used by separable_convolution(): compute every 'stride'-th output
+            // sample along each axis, i.e. fuse the convolution with downsampling
+        stride_vec output_strides{1};
+            // only used by convolution(): execute 2D kernels as a sum of separable
+            // terms when this is cheaper and the relative error is below 'tolerance'
+        bool low_rank = true;
+        double low_rank_tolerance = 1e-6;
+        convolution_method method = auto_convolution;
 
         convolution_options & use_simd(bool v=true)
         {
@@ -62,6 +83,19 @@ namespace xvigra
             return *this;
         }
 
+        convolution_options & use_low_rank(bool v=true, double tolerance=1e-6)
+        {
+            low_rank = v;
+            low_rank_tolerance = tolerance;
+            return *this;
+        }
+
+        convolution_options & use_method(convolution_method m)
+        {
+            method = m;
+            return *this;
+        }
+
         convolution_options & padding(padding_mode p)
         {
             return padding(p, p);
@@ -112,6 +146,46 @@ namespace xvigra
                 "convolution_options.get_right_padding(d): requested dimension out of bounds.");
             return right_padding[d];
         }
+
+        convolution_options & output_stride(index_t s)
+        {
+            output_strides = stride_vec{s};
+            return *this;
+        }
+
+        template <index_t N>
+        convolution_options & output_stride(tiny_vector<index_t, N> const & s)
+        {
+            output_strides = s;
+            return *this;
+        }
+
+        index_t get_output_stride(index_t d) const
+        {
+            if(output_strides.size() == 0)
+            {
+                return 1;
+            }
+            if(output_strides.size() == 1)
+            {
+                return output_strides[0];
+            }
+            vigra_precondition(0 <= d && d < output_strides.size(),
+                "convolution_options.get_output_stride(d): requested dimension out of bounds.");
+            return output_strides[d];
+        }
+
+        bool has_output_stride() const
+        {
+            for(index_t k=0; k<output_strides.size(); ++k)
+            {
+                if(output_strides[k] != 1)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
     };
 
     /******************************/
@@ -152,31 +226,30 @@ namespace xvigra
 
         index_t N = in.dimension();
 
-        slicer nav(in.shape());
         {
             // operate on last dimension first
-            nav.set_free_axes(N-1);
             padding_mode left_padding  = options.get_left_padding(N-1),
                          right_padding = options.get_right_padding(N-1);
             array_nd<T2, 1> padded(shape_t<1>{in.shape(N-1)+left+right});
-            for(; nav.has_more(); ++nav)
+            auto in_lines  = in.lines(N-1);
+            auto out_lines = out.lines(N-1);
+            for(; in_lines.has_more(); ++in_lines, ++out_lines)
             {
-                copy_with_padding(in.view(*nav), padded, left_padding, left, right_padding, right);
-                detail::convolve_row(padded, out.view(*nav), rev_kernel);
+                copy_with_padding(*in_lines, padded, left_padding, left, right_padding, right);
+                detail::convolve_row(padded, *out_lines, rev_kernel);
             }
         }
 
         for( index_t d = N-2; d >= 0; --d )
         {
             // operate on further dimensions
-            nav.set_free_axes(d);
             padding_mode left_padding  = options.get_left_padding(d),
                          right_padding = options.get_right_padding(d);
             array_nd<T2, 1> padded(shape_t<1>{out.shape(d)+left+right});
-            for(; nav.has_more(); ++nav)
+            for(auto line = out.lines(d); line.has_more(); ++line)
             {
-                copy_with_padding(out.view(*nav), padded, left_padding, left, right_padding, right);
-                detail::convolve_row(padded, out.view(*nav), rev_kernel);
+                copy_with_padding(*line, padded, left_padding, left, right_padding, right);
+                detail::convolve_row(padded, *line, rev_kernel);
             }
         }
     }
@@ -187,6 +260,13 @@ namespace xvigra
 
     namespace detail
     {
+            // element types supported by simd_mul_row() and simd_fma_row()
+        template <class T1, class T2>
+        struct simd_row_types
+        : public std::integral_constant<bool,
+                     std::is_same<T1, T2>::value &&
+                     (std::is_same<T1, float>::value || std::is_same<T1, double>::value)>
+        {};
 
     #if XVIGRA_USE_SIMD
         template <class T,
@@ -208,9 +288,20 @@ namespace xvigra
             }
 
             index_t simd_end = size - size % simd_size;
-            for(index_t j=0; j<simd_end; j += simd_size)
+            if(((std::size_t)src & align_bits) == 0)
+            {
+                // src and dest are equally aligned, e.g. rows of aligned temporaries
+                for(index_t j=0; j<simd_end; j += simd_size)
+                {
+                    (ba * xsimd::load_aligned(src+j)).store_aligned(dest+j);
+                }
+            }
+            else
             {
-                (ba * xsimd::load_unaligned(src+j)).store_aligned(dest+j);
+                for(index_t j=0; j<simd_end; j += simd_size)
+                {
+                    (ba * xsimd::load_unaligned(src+j)).store_aligned(dest+j);
+                }
             }
             for(index_t j=simd_end; j<size; ++j)
             {
@@ -237,15 +328,156 @@ namespace xvigra
             }
 
             index_t simd_end = size - size % simd_size;
-            for(index_t j=0; j<simd_end; j += simd_size)
+            if(((std::size_t)src & align_bits) == 0)
+            {
+                for(index_t j=0; j<simd_end; j += simd_size)
+                {
+                    xsimd::fma(ba, xsimd::load_aligned(src+j), xsimd::load_aligned(dest+j)).store_aligned(dest+j);
+                }
+            }
+            else
             {
-                xsimd::fma(ba, xsimd::load_unaligned(src+j), xsimd::load_aligned(dest+j)).store_aligned(dest+j);
+                for(index_t j=0; j<simd_end; j += simd_size)
+                {
+                    xsimd::fma(ba, xsimd::load_unaligned(src+j), xsimd::load_aligned(dest+j)).store_aligned(dest+j);
+                }
             }
             for(index_t j=simd_end; j<size; ++j)
             {
                 *(dest+j) += *(src+j) * a;
             }
         }
+
+        template <bool ALIGNED, class T>
+        inline auto simd_load_row(T const * p)
+        {
+            return ALIGNED ? xsimd::load_aligned(p) : xsimd::load_unaligned(p);
+        }
+
+            // dest[j] = sum_t weights[t] * rows[t][j]: the accumulators for a strip
+            // of four SIMD registers (32 floats with AVX2, 64 with AVX-512) stay
+            // in registers over all taps, so that 'dest' is written only once
+        template <bool ALIGNED, class T>
+        inline void simd_column_row_impl(T const * const * rows, T const * weights,
+                                         index_t taps, index_t size, T * dest)
+        {
+            using batch = decltype(xsimd::set_simd(T()));
+            constexpr index_t simd_size = xsimd::simd_batch_traits<batch>::size;
+
+            index_t j = 0;
+            for(; j + 4*simd_size <= size; j += 4*simd_size)
+            {
+                batch w = xsimd::set_simd(weights[0]);
+                T const * row = rows[0] + j;
+                batch a0 = w * simd_load_row<ALIGNED>(row),
+                      a1 = w * simd_load_row<ALIGNED>(row + simd_size),
+                      a2 = w * simd_load_row<ALIGNED>(row + 2*simd_size),
+                      a3 = w * simd_load_row<ALIGNED>(row + 3*simd_size);
+                for(index_t t=1; t<taps; ++t)
+                {
+                    w = xsimd::set_simd(weights[t]);
+                    row = rows[t] + j;
+                    a0 = xsimd::fma(w, simd_load_row<ALIGNED>(row), a0);
+                    a1 = xsimd::fma(w, simd_load_row<ALIGNED>(row + simd_size), a1);
+                    a2 = xsimd::fma(w, simd_load_row<ALIGNED>(row + 2*simd_size), a2);
+                    a3 = xsimd::fma(w, simd_load_row<ALIGNED>(row + 3*simd_size), a3);
+                }
+                a0.store_unaligned(dest + j);
+                a1.store_unaligned(dest + j + simd_size);
+                a2.store_unaligned(dest + j + 2*simd_size);
+                a3.store_unaligned(dest + j + 3*simd_size);
+            }
+            for(; j + simd_size <= size; j += simd_size)
+            {
+                batch a = xsimd::set_simd(weights[0]) * simd_load_row<ALIGNED>(rows[0] + j);
+                for(index_t t=1; t<taps; ++t)
+                {
+                    a = xsimd::fma(xsimd::set_simd(weights[t]), simd_load_row<ALIGNED>(rows[t] + j), a);
+                }
+                a.store_unaligned(dest + j);
+            }
+            for(; j<size; ++j)
+            {
+                T a = weights[0] * rows[0][j];
+                for(index_t t=1; t<taps; ++t)
+                {
+                    a += weights[t] * rows[t][j];
+                }
+                dest[j] = a;
+            }
+        }
+
+        template <class T,
+                  VIGRA_REQUIRE<std::is_floating_point<T>::value>>
+        inline void simd_column_row(T const * const * rows, T const * weights,
+                                    index_t taps, index_t size, T * dest)
+        {
+            using batch = decltype(xsimd::set_simd(T()));
+            constexpr std::size_t align_bits = xsimd::simd_batch_traits<batch>::align - 1;
+
+            // the input rows are aligned when they come from an aligned temporary
+            bool aligned = true;
+            for(index_t t=0; t<taps; ++t)
+            {
+                aligned = aligned && ((std::size_t)rows[t] & align_bits) == 0;
+            }
+            if(aligned)
+            {
+                simd_column_row_impl<true>(rows, weights, taps, size, dest);
+            }
+            else
+            {
+                simd_column_row_impl<false>(rows, weights, taps, size, dest);
+            }
+        }
+    #elif defined(XVIGRA_USE_SIMD_DISPATCH)
+            // kernels compiled for several instruction sets, selected at runtime
+        inline void simd_mul_row(float const * src, index_t size, float * dest, float a)
+        {
+            dispatch_mul_row(src, size, dest, a);
+        }
+
+        inline void simd_mul_row(double const * src, index_t size, double * dest, double a)
+        {
+            dispatch_mul_row(src, size, dest, a);
+        }
+
+        inline void simd_fma_row(float const * src, index_t size, float * dest, float a)
+        {
+            dispatch_fma_row(src, size, dest, a);
+        }
+
+        inline void simd_fma_row(double const * src, index_t size, double * dest, double a)
+        {
+            dispatch_fma_row(src, size, dest, a);
+        }
+
+        inline void simd_column_row(float const * const * rows, float const * weights,
+                                    index_t taps, index_t size, float * dest)
+        {
+            dispatch_column_row(rows, weights, taps, size, dest);
+        }
+
+        inline void simd_column_row(double const * const * rows, double const * weights,
+                                    index_t taps, index_t size, double * dest)
+        {
+            dispatch_column_row(rows, weights, taps, size, dest);
+        }
+
+            // only reached for unsupported type combinations, where 'use_simd' is false
+        template <class T1, class T2, class T3,
+                  VIGRA_REQUIRE<!simd_row_types<T1, T2>::value>>
+        inline void simd_mul_row(T1 const * src, index_t size, T2 * dest, T3 a)
+        {
+            vigra_fail("internal error: invalid call to SIMD function.");
+        }
+
+        template <class T1, class T2, class T3,
+                  VIGRA_REQUIRE<!simd_row_types<T1, T2>::value>>
+        inline void simd_fma_row(T1 const * src, index_t size, T2 * dest, T3 a)
+        {
+            vigra_fail("internal error: invalid call to SIMD function.");
+        }
     #else
         template <class T1, class T2, class T3>
         inline void simd_mul_row(T1 const * src, index_t size, T2 * dest, T3 a)
@@ -258,6 +490,13 @@ namespace xvigra
         {
             vigra_fail("internal error: invalid call to SIMD function.");
         }
+
+        template <class T>
+        inline void simd_column_row(T const * const * rows, T const * weights,
+                                    index_t taps, index_t size, T * dest)
+        {
+            vigra_fail("internal error: invalid call to SIMD function.");
+        }
     #endif
 
     } // namespace detail
@@ -269,38 +508,84 @@ namespace xvigra
     {
         std::string name = "separable_convolution";
 
-        template <class E1, class E2, class ... ARGS>
+        template <class E1, class E2,
+                  VIGRA_REQUIRE<!planar_view_nd_concept<E1>::value>,
+                  class ... ARGS>
         void operator()(E1 && e1, E2 && e2, ARGS ... a) const
         {
+            XVIGRA_INSTRUMENT_SCOPE(name);
+            XVIGRA_TRACE_SCOPE(name, "functor");
             auto && a1 = eval_expr(std::forward<E1>(e1));
             auto && a2 = eval_expr(std::forward<E2>(e2));
-            impl(0, make_view(a1), make_view(a2), std::forward<ARGS>(a)...);
+            using T1 = typename std::decay_t<decltype(make_view(a1))>::value_type;
+            XVIGRA_INSTRUMENT_EVAL(E1, a1);
+            XVIGRA_INSTRUMENT_IO(a1.size(), a1.size()*sizeof(*make_view(a1).raw_data()),
+                                 a2.size()*sizeof(*make_view(a2).raw_data()));
+            impl_dispatch(tiny_vector_concept<std::remove_const_t<T1>>(),
+                          make_view(a1), make_view(a2), std::forward<ARGS>(a)...);
+        }
+
+            // convolve planar multi-channel arrays one contiguous plane at a time
+        template <class P1, class P2,
+                  VIGRA_REQUIRE<planar_view_nd_concept<P1>::value && planar_view_nd_concept<P2>::value>,
+                  class ... ARGS>
+        void operator()(P1 const & p1, P2 const & p2, ARGS ... a) const
+        {
+            XVIGRA_INSTRUMENT_SCOPE(name);
+            XVIGRA_TRACE_SCOPE(name, "functor");
+            vigra_precondition(p1.channels() == p2.channels(),
+                name + "(): number of channels mismatch between input and output.");
+            for(index_t c=0; c<p1.channels(); ++c)
+            {
+                auto c1 = p1.channel(c);
+                auto c2 = p2.channel(c);
+                XVIGRA_INSTRUMENT_IO(c1.size(), c1.size()*sizeof(*c1.raw_data()), c2.size()*sizeof(*c2.raw_data()));
+                impl(0, c1, c2, a...);
+            }
         }
 
         template <class E1, class E2, class ... ARGS>
         void operator()(dimension_hint dim, E1 && e1, E2 && e2, ARGS ... a) const
         {
+            XVIGRA_INSTRUMENT_SCOPE(name);
+            XVIGRA_TRACE_SCOPE(name, "functor");
             vigra_precondition((index_t)e1.dimension() == dim || (index_t)e1.dimension() == dim+1,
                 name + "(): input dimension contradicts dimension_hint.");
 
             auto && a1 = eval_expr(std::forward<E1>(e1));
             auto && a2 = eval_expr(std::forward<E2>(e2));
+            XVIGRA_INSTRUMENT_EVAL(E1, a1);
+            XVIGRA_INSTRUMENT_IO(a1.size(), a1.size()*sizeof(*make_view(a1).raw_data()),
+                                 a2.size()*sizeof(*make_view(a2).raw_data()));
 
             if((index_t)a1.dimension() == dim)
             {
                 impl(0, make_view(a1), make_view(a2), std::forward<ARGS>(a)...);
+                return;
+            }
+
+            auto && v1 = make_view(a1);
+            auto && v2 = make_view(a2);
+            // spatial shapes may differ when output strides are given,
+            // they are checked by impl()
+            vigra_precondition(v1.dimension() == v2.dimension() && v1.shape(dim) == v2.shape(dim),
+                name + "(): shape mismatch between input and output.");
+
+            index_t channels = v1.shape(dim);
+            if(dim > 0 && channels > 1 && v1.shape() == v2.shape() &&
+               v1.strides(dim) == 1 && v1.strides(dim-1) == channels &&
+               v2.strides(dim) == 1 && v2.strides(dim-1) == channels)
+            {
+                // interleaved channels: merge the channel axis with the innermost
+                // spatial axis and convolve all channels in a single pass
+                impl_interleaved(0, merge_channel_axis(v1), merge_channel_axis(v2),
+                                 channels, std::forward<ARGS>(a)...);
             }
-            // else if(a1.strides(dim) == 1 && a2.strides(dim) == 1)
-            // {
-            //     // FIXME: implement simultaneous convolution over innermost dimension and channels
-            // }
             else
             {
-                auto && v1 = make_view(a1);
-                auto && v2 = make_view(a2);
-                for(index_t k=0; k<v1.shape(dim); ++k)
+                for(index_t k=0; k<channels; ++k)
                 {
-                    impl(0, v1.bind(dim, k), v2.bind(dim, k), std::forward<ARGS>(a)...);
+                    impl(0, v1.bind(dim, k), v2.bind(dim, k), a...);
                 }
             }
         }
@@ -320,6 +605,11 @@ namespace xvigra
                   Kernels && kernels,
                   convolution_options const & options = convolution_options()) const
         {
+            if(options.has_output_stride())
+            {
+                impl_strided(dim, std::move(in), std::move(out), std::forward<Kernels>(kernels), options);
+                return;
+            }
             vigra_precondition(in.shape() == out.shape(),
                 name + "(): shape mismatch between input and output.");
             vigra_precondition(dim > 0 || kernels.size() == in.dimension(),
@@ -337,31 +627,284 @@ namespace xvigra
             else
             {
                 using tmp_type = std::conditional_t<std::is_integral<T1>::value, float, T1>;
-                array_nd<tmp_type> tmp(in.shape()); // FIXME: use less tmp memory
-                for(index_t k=0; k<in.shape(0); ++k)
+                auto tmp = detail::allocate_aligned_temporary<tmp_type>(shape_t<>(in.shape())); // FIXME: use less tmp memory
                 {
-                    impl(dim+1, in.bind(0,k), tmp.bind(0,k), kernels, options);
+                    // the rows of a 2D array form the pass over axis 'dim+1',
+                    // higher-dimensional slices are traced by the recursive call
+                    XVIGRA_TRACE_SCOPE(in.dimension() == 2 ? "axis " + std::to_string(dim+1) : "slices", "stage");
+                    for(index_t k=0; k<in.shape(0); ++k)
+                    {
+                        impl(dim+1, in.bind(0,k), tmp.bind(0,k), kernels, options);
+                    }
                 }
-                slicer nav(out.shape());
-                nav.set_free_axes(shape_t<>{0, (index_t)out.dimension()-1});
-                for(; nav.has_more(); ++nav)
+                XVIGRA_TRACE_SCOPE("axis " + std::to_string(dim), "stage");
+                shape_t<2> free_axes{0, (index_t)out.dimension()-1};
+                auto tmp_planes = tmp.hyperplanes(free_axes);
+                auto out_planes = out.hyperplanes(free_axes);
+                for(; out_planes.has_more(); ++tmp_planes, ++out_planes)
                 {
                     // execute convolution over left-most dimension, working
                     // along rows in the inner loop
-                    convolve_columns(tmp.view(*nav).template view<2>(), out.view(*nav).template view<2>(),
+                    convolve_columns(*tmp_planes, *out_planes,
+                                     kernels[dim], options.simd, left_padding, right_padding);
+                }
+            }
+        }
+
+            // Convolution with output strides (see convolution_options::output_stride()):
+            // 'out' holds every 'stride'-th sample of the full result along each axis,
+            // i.e. out.shape(d) == ceil(in.shape(d) / stride(d)). Only the retained
+            // samples are computed: the row pass produces the decimated columns of all
+            // input rows, and the column pass only the retained rows.
+        template <class T1, index_t N1, class T2, index_t N2, class Kernels>
+        void impl_strided(index_t dim, view_nd<T1, N1> in, view_nd<T2, N2> out,
+                          Kernels && kernels, convolution_options const & options) const
+        {
+            vigra_precondition(in.dimension() == out.dimension(),
+                name + "(): dimension mismatch between input and output.");
+            vigra_precondition(dim > 0 || kernels.size() == in.dimension(),
+                name + "(): number of kernels doesn't match data dimension.");
+
+            index_t stride = options.get_output_stride(dim);
+            vigra_precondition(stride > 0,
+                name + "(): output stride must be positive.");
+            vigra_precondition(out.shape(0) == (in.shape(0) + stride - 1) / stride,
+                name + "(): output shape must equal the input shape divided by the output stride (rounded up).");
+
+            padding_mode left_padding  = options.get_left_padding(dim),
+                         right_padding = options.get_right_padding(dim);
+
+            if(in.dimension() == 1)
+            {
+                convolve_row_strided(in.template view<1>(), out.template view<1>(), kernels[dim],
+                                     stride, left_padding, right_padding);
+            }
+            else
+            {
+                using tmp_type = std::conditional_t<std::is_integral<T1>::value, float, T1>;
+                shape_t<> tmp_shape(out.shape());
+                tmp_shape[0] = in.shape(0);
+                auto tmp = detail::allocate_aligned_temporary<tmp_type>(tmp_shape);
+                {
+                    XVIGRA_TRACE_SCOPE(in.dimension() == 2 ? "axis " + std::to_string(dim+1) : "slices", "stage");
+                    for(index_t k=0; k<in.shape(0); ++k)
+                    {
+                        impl_strided(dim+1, in.bind(0,k), tmp.bind(0,k), kernels, options);
+                    }
+                }
+                XVIGRA_TRACE_SCOPE("axis " + std::to_string(dim), "stage");
+                shape_t<2> free_axes{0, (index_t)out.dimension()-1};
+                auto tmp_planes = tmp.hyperplanes(free_axes);
+                auto out_planes = out.hyperplanes(free_axes);
+                for(; out_planes.has_more(); ++tmp_planes, ++out_planes)
+                {
+                    convolve_columns_strided(*tmp_planes, *out_planes, kernels[dim], stride,
+                                             options.simd, left_padding, right_padding);
+                }
+            }
+        }
+
+            // scalar pixels
+        template <class V1, class V2, class ... ARGS>
+        void impl_dispatch(std::false_type, V1 && v1, V2 && v2, ARGS && ... a) const
+        {
+            impl(0, std::forward<V1>(v1), std::forward<V2>(v2), std::forward<ARGS>(a)...);
+        }
+
+            // tiny_vector pixels: expand the elements into a trailing channel axis,
+            // which is then convolved by the interleaved code path
+        template <class T1, index_t N1, class T2, index_t N2, class ... ARGS>
+        void impl_dispatch(std::true_type, view_nd<T1, N1> v1, view_nd<T2, N2> v2, ARGS && ... a) const
+        {
+            index_t dim = v1.dimension();
+            (*this)(dimension_hint(dim), v1.expand_elements(dim), v2.expand_elements(dim),
+                    std::forward<ARGS>(a)...);
+        }
+
+            // Convolution of arrays whose innermost axis holds the interleaved
+            // channels of the pixels along the last spatial axis (i.e. 'channels'
+            // consecutive elements belong to the same pixel, see merge_channel_axis()).
+        template <class T1, index_t N1, class T2, index_t N2, class T3>
+        void impl_interleaved(index_t dim, view_nd<T1, N1> in, view_nd<T2, N2> out,
+                              index_t channels, kernel_1d<T3> const & kernel,
+                              convolution_options const & options = convolution_options()) const
+        {
+            impl_interleaved(dim, std::move(in), std::move(out), channels,
+                             std::vector<kernel_1d<T3>>(in.dimension(), kernel), options);
+        }
+
+        template <class T1, index_t N1, class T2, index_t N2, class Kernels,
+                  VIGRA_REQUIRE<kernel_1d_concept<typename std::decay_t<Kernels>::value_type>::value>>
+        void impl_interleaved(index_t dim, view_nd<T1, N1> in, view_nd<T2, N2> out,
+                              index_t channels, Kernels && kernels,
+                              convolution_options const & options = convolution_options()) const
+        {
+            if(options.has_output_stride())
+            {
+                // a stride on the merged axis would mix the channels,
+                // so that each channel is convolved by impl_strided()
+                auto in_channels  = split_channel_axis(in, channels),
+                     out_channels = split_channel_axis(out, channels);
+                index_t m = in.dimension();
+                for(index_t c=0; c<channels; ++c)
+                {
+                    impl_strided(dim, in_channels.bind(m, c), out_channels.bind(m, c), kernels, options);
+                }
+                return;
+            }
+            vigra_precondition(in.shape() == out.shape(),
+                name + "(): shape mismatch between input and output.");
+            vigra_precondition(dim > 0 || kernels.size() == in.dimension(),
+                name + "(): number of kernels doesn't match data dimension.");
+
+            padding_mode left_padding  = options.get_left_padding(dim),
+                         right_padding = options.get_right_padding(dim);
+
+            if(in.dimension() == 1)
+            {
+                // execute convolution over right-most dimension
+                convolve_interleaved_row(in.template view<1>(), out.template view<1>(), channels,
+                                         kernels[dim], options.simd, left_padding, right_padding);
+            }
+            else
+            {
+                using tmp_type = std::conditional_t<std::is_integral<T1>::value, float, T1>;
+                auto tmp = detail::allocate_aligned_temporary<tmp_type>(shape_t<>(in.shape()));
+                {
+                    XVIGRA_TRACE_SCOPE(in.dimension() == 2 ? "axis " + std::to_string(dim+1) : "slices", "stage");
+                    for(index_t k=0; k<in.shape(0); ++k)
+                    {
+                        impl_interleaved(dim+1, in.bind(0,k), tmp.bind(0,k), channels, kernels, options);
+                    }
+                }
+                XVIGRA_TRACE_SCOPE("axis " + std::to_string(dim), "stage");
+                // the merged rows are contiguous, so that the column convolution
+                // processes all channels at once
+                shape_t<2> free_axes{0, (index_t)out.dimension()-1};
+                auto tmp_planes = tmp.hyperplanes(free_axes);
+                auto out_planes = out.hyperplanes(free_axes);
+                for(; out_planes.has_more(); ++tmp_planes, ++out_planes)
+                {
+                    convolve_columns(*tmp_planes, *out_planes,
                                      kernels[dim], options.simd, left_padding, right_padding);
                 }
             }
         }
 
+            // Merge the channel axis (the last axis, which must have stride 1)
+            // with the preceding spatial axis.
+        template <class T, index_t N>
+        view_nd<T> merge_channel_axis(view_nd<T, N> const & v) const
+        {
+            index_t m = v.dimension() - 1;
+            shape_t<> shape(v.shape().pop_back()),
+                      strides(v.strides().pop_back());
+            shape[m-1] *= v.shape(m);
+            strides[m-1] = 1;
+            return view_nd<T>(shape, strides, const_cast<T *>(v.raw_data()));
+        }
+
+            // Inverse of merge_channel_axis(): split the innermost axis into
+            // pixels and their 'channels' interleaved elements.
+        template <class T, index_t N>
+        view_nd<T> split_channel_axis(view_nd<T, N> const & v, index_t channels) const
+        {
+            index_t m = v.dimension() - 1;
+            vigra_precondition(v.strides(m) == 1 && v.shape(m) % channels == 0,
+                name + "(): innermost axis doesn't hold interleaved channels.");
+            shape_t<> shape(v.shape()),
+                      strides(v.strides());
+            shape[m] /= channels;
+            strides[m] = channels;
+            return view_nd<T>(shape.push_back(channels), strides.push_back(1),
+                              const_cast<T *>(v.raw_data()));
+        }
+
+        template <class T1, class T2, class T3>
+        void convolve_interleaved_row(view_nd<T1, 1> && in, view_nd<T2, 1> && out, index_t channels,
+                                      kernel_1d<T3> const & kernel, bool use_simd,
+                                      padding_mode left_padding, padding_mode right_padding) const
+        {
+#if defined(XVIGRA_USE_SIMD) || defined(XVIGRA_USE_SIMD_DISPATCH)
+            use_simd = use_simd && detail::simd_row_types<T1, T2>::value;
+#else
+            use_simd = false;
+#endif
+            using namespace slicing;
+            auto rev_kernel = kernel.view(slice(_,_,-1));
+            index_t right = kernel.center(),
+                    left  = kernel.size() - right - 1;
+            index_t size  = in.shape(0) / channels;
+            index_t start = (left_padding == no_padding) ? left : 0;
+            index_t end   = (right_padding == no_padding) ? size - right : size;
+            T1 const * src  = in.raw_data();
+            T2       * dest = out.raw_data();
+
+            if(use_simd)
+            {
+                detail::simd_mul_row(src + start*channels, (end-start)*channels,
+                                     dest + start*channels, rev_kernel(left));
+            }
+            else
+            {
+                for(index_t l=start*channels; l<end*channels; ++l)
+                {
+                    dest[l] = rev_kernel(left)*src[l];
+                }
+            }
+            for(index_t k=-left; k<=right; ++k)
+            {
+                if(k==0)
+                {
+                    continue;
+                }
+                auto w = rev_kernel(k+left);
+
+                // interior: pixels whose neighbor 'l+k' is inside the row
+                index_t lo = std::max(start, -k),
+                        hi = std::min(end, size - k);
+                if(use_simd && lo < hi)
+                {
+                    detail::simd_fma_row(src + (lo+k)*channels, (hi-lo)*channels,
+                                         dest + lo*channels, w);
+                }
+                else
+                {
+                    for(index_t l=lo*channels; l<hi*channels; ++l)
+                    {
+                        dest[l] += w*src[l+k*channels];
+                    }
+                }
+
+                // borders: pixels whose neighbor is determined by the padding mode
+                for(index_t l=start; l<end; ++l)
+                {
+                    if(lo <= l && l < hi)
+                    {
+                        l = hi - 1;
+                        continue;
+                    }
+                    index_t i = l + k;
+                    if(!adjust_index_near_border(i, size, left_padding, right_padding))
+                    {
+                        continue; // if zero_padding
+                    }
+                    for(index_t c=0; c<channels; ++c)
+                    {
+                        dest[l*channels+c] += w*src[i*channels+c];
+                    }
+                }
+            }
+        }
+
         template <class T1, class T2, class T3>
         void convolve_row(view_nd<T1, 1> && in, view_nd<T2, 1> && out,
                           kernel_1d<T3> const & kernel, bool use_simd,
                           padding_mode left_padding, padding_mode right_padding) const
         {
-#ifdef XVIGRA_USE_SIMD
+#if defined(XVIGRA_USE_SIMD) || defined(XVIGRA_USE_SIMD_DISPATCH)
             use_simd = use_simd && out.is_contiguous() &&
-                       std::is_same<T1, T2>::value && std::is_floating_point<T1>::value;
+                       detail::simd_row_types<T1, T2>::value;
 #else
             use_simd = false;
 #endif
@@ -371,6 +914,19 @@ namespace xvigra
                     left  = kernel.size() - right - 1;
             index_t start = (left_padding == no_padding) ? left : 0;
             index_t end   = (right_padding == no_padding) ? in.shape(0) - right : in.shape(0);
+            switch(kernel.size())
+            {
+                // small kernels: a single pass with unrolled taps
+                case 3:
+                    return convolve_row_fixed<3>(in, out, rev_kernel, left, start, end,
+                                                 left_padding, right_padding);
+                case 5:
+                    return convolve_row_fixed<5>(in, out, rev_kernel, left, start, end,
+                                                 left_padding, right_padding);
+                case 7:
+                    return convolve_row_fixed<7>(in, out, rev_kernel, left, start, end,
+                                                 left_padding, right_padding);
+            }
             if(use_simd && in.is_contiguous())
             {
                 detail::simd_mul_row(&in(start), end-start, &out(start), rev_kernel(left));
@@ -380,12 +936,17 @@ namespace xvigra
                 // out.view(slice(start, end)) += rev_kernel(left)*in.view(slice(start, end));
                 for(index_t l=start; l<end; ++l)
                 {
-                    out(l) = rev_kernel(left)*in(l+start);
+                    out(l) = rev_kernel(left)*in(l);
                 }
             }
             if(!in.is_contiguous())
             {
-                array_nd<float, 1> padded(shape_t<1>{in.shape(0)+left+right});
+                // the padded copy keeps the input type, so that it is exact
+                // (and equals T2 whenever the SIMD functions are used)
+                using padded_type = std::remove_const_t<T1>;
+                shape_t<1> padded_shape{in.shape(0)+left+right};
+                view_nd<padded_type, 1> padded(padded_shape,
+                                               detail::line_buffer<padded_type>(padded_shape[0]));
                 copy_with_padding(in, padded, left_padding, left, right_padding, right);
                 for(index_t k=0; k<rev_kernel.size(); ++k)
                 {
@@ -402,7 +963,7 @@ namespace xvigra
                         // out.view(slice(start, end)) += rev_kernel(k)*padded.view(slice(k+start, k+end));
                         for(index_t l=start; l<end; ++l)
                         {
-                            out(l) += rev_kernel(k)*padded(l+k+start);
+                            out(l) += rev_kernel(k)*padded(l+k);
                         }
                     }
                 }
@@ -596,10 +1157,10 @@ namespace xvigra
                               kernel_1d<T3> const & kernel, bool use_simd,
                               padding_mode left_padding, padding_mode right_padding) const
         {
-#ifdef XVIGRA_USE_SIMD
+#if defined(XVIGRA_USE_SIMD) || defined(XVIGRA_USE_SIMD_DISPATCH)
             use_simd = use_simd &&
                        in.bind(0,0).is_contiguous() && out.bind(0,0).is_contiguous() &&
-                       std::is_same<T1, T2>::value && std::is_floating_point<T1>::value;
+                       detail::simd_row_types<T1, T2>::value;
 #else
             use_simd = false;
 #endif
@@ -610,19 +1171,31 @@ namespace xvigra
             // FIXME: optimize for (a)symmetric kernels
             index_t start = (left_padding == no_padding) ? left : 0;
             index_t end   = (right_padding == no_padding) ? in.shape(0) - right : in.shape(0);
+            if(use_simd)
+            {
+                convolve_columns_blocked(detail::simd_row_types<T1, T2>(), in, out, rev_kernel,
+                                         left, right, start, end, left_padding, right_padding);
+                return;
+            }
+            switch(kernel.size())
+            {
+                // small kernels: a single pass with unrolled taps
+                case 3:
+                    return convolve_columns_fixed<3>(in, out, rev_kernel, left, start, end,
+                                                     left_padding, right_padding);
+                case 5:
+                    return convolve_columns_fixed<5>(in, out, rev_kernel, left, start, end,
+                                                     left_padding, right_padding);
+                case 7:
+                    return convolve_columns_fixed<7>(in, out, rev_kernel, left, start, end,
+                                                     left_padding, right_padding);
+            }
             for(index_t j=start; j<end; ++j)
             {
-                if(use_simd)
-                {
-                    detail::simd_mul_row(&in(j,0), in.shape(1), &out(j,0), rev_kernel(left));
-                }
-                else
+                // out.bind(0, j) += rev_kernel(left)*in.bind(0,j);
+                for(index_t l=0; l<in.shape(1); ++l)
                 {
-                    // out.bind(0, j) += rev_kernel(left)*in.bind(0,j);
-                    for(index_t l=0; l<in.shape(1); ++l)
-                    {
-                        out(j,l) = rev_kernel(left)*in(j,l);
-                    }
+                    out(j,l) = rev_kernel(left)*in(j,l);
                 }
                 for(index_t k=-left; k<=right; ++k)
                 {
@@ -636,17 +1209,10 @@ namespace xvigra
                         continue; // if zero_padding
                     }
 
-                    if(use_simd)
-                    {
-                        detail::simd_fma_row(&in(i,0), in.shape(1), &out(j,0), rev_kernel(k+left));
-                    }
-                    else
+                    // out.bind(0, j) += rev_kernel(k+left)*in.bind(0,i);
+                    for(index_t l=0; l<in.shape(1); ++l)
                     {
-                        // out.bind(0, j) += rev_kernel(k+left)*in.bind(0,i);
-                        for(index_t l=0; l<in.shape(1); ++l)
-                        {
-                            out(j,l) += rev_kernel(k+left)*in(i,l);
-                        }
+                        out(j,l) += rev_kernel(k+left)*in(i,l);
                     }
                 }
                 // // experimental: use symmetry of the kernel, minimal speed advantage (within measurement noise)
@@ -676,6 +1242,306 @@ namespace xvigra
                 // }
             }
         }
+
+            // Row convolution computing only the output samples 'j' at input
+            // positions 'j*stride'. Only the samples near the row ends need the
+            // padding rules.
+        template <class T1, class T2, class T3>
+        void convolve_row_strided(view_nd<T1, 1> const & in, view_nd<T2, 1> out,
+                                  kernel_1d<T3> const & kernel, index_t stride,
+                                  padding_mode left_padding, padding_mode right_padding) const
+        {
+            using namespace slicing;
+            auto rev_kernel = kernel.view(slice(_,_,-1));
+            using weight_type = std::common_type_t<std::decay_t<decltype(rev_kernel(0))>,
+                                                   std::remove_const_t<T1>>;
+            index_t ksize = kernel.size(),
+                    right = kernel.center(),
+                    left  = ksize - right - 1,
+                    size  = in.shape(0),
+                    ss    = in.strides(0);
+            T1 const * src = in.raw_data();
+
+            for(index_t j=0; j<out.shape(0); ++j)
+            {
+                index_t l = j*stride;
+                if((left_padding == no_padding && l < left) ||
+                   (right_padding == no_padding && l >= size - right))
+                {
+                    continue; // output outside the valid region remains unchanged
+                }
+                weight_type sum = weight_type();
+                if(l >= left && l + right < size)
+                {
+                    T1 const * p = src + (l - left)*ss;
+                    for(index_t t=0; t<ksize; ++t)
+                    {
+                        sum += rev_kernel(t)*p[t*ss];
+                    }
+                }
+                else
+                {
+                    for(index_t t=0; t<ksize; ++t)
+                    {
+                        index_t i = l - left + t;
+                        if(adjust_index_near_border(i, size, left_padding, right_padding))
+                        {
+                            sum += rev_kernel(t)*src[i*ss];
+                        }
+                    }
+                }
+                out(j) = sum;
+            }
+        }
+
+            // Column convolution computing only the output rows 'j' at input rows
+            // 'j*stride'. The contributing input rows are gathered first, as in
+            // convolve_columns_blocked().
+        template <class T1, class T2, class T3>
+        void convolve_columns_strided(view_nd<T1, 2> const & in, view_nd<T2, 2> out,
+                                      kernel_1d<T3> const & kernel, index_t stride, bool use_simd,
+                                      padding_mode left_padding, padding_mode right_padding) const
+        {
+            using namespace slicing;
+            auto rev_kernel = kernel.view(slice(_,_,-1));
+            using weight_type = std::common_type_t<std::decay_t<decltype(rev_kernel(0))>,
+                                                   std::remove_const_t<T1>>;
+            using simd_types = std::integral_constant<bool,
+                                   detail::simd_row_types<T1, T2>::value &&
+                                   std::is_same<weight_type, T2>::value>;
+#if defined(XVIGRA_USE_SIMD) || defined(XVIGRA_USE_SIMD_DISPATCH)
+            use_simd = use_simd && simd_types::value &&
+                       in.strides(1) == 1 && out.strides(1) == 1;
+#else
+            use_simd = false;
+#endif
+            index_t ksize = kernel.size(),
+                    right = kernel.center(),
+                    left  = ksize - right - 1,
+                    size  = in.shape(0),
+                    width = in.shape(1),
+                    ss    = in.strides(1),
+                    ds    = out.strides(1);
+            std::vector<T1 const *> rows(ksize);
+            std::vector<weight_type> weights(ksize);
+
+            for(index_t j=0; j<out.shape(0); ++j)
+            {
+                index_t l = j*stride;
+                if((left_padding == no_padding && l < left) ||
+                   (right_padding == no_padding && l >= size - right))
+                {
+                    continue; // output outside the valid region remains unchanged
+                }
+                index_t taps = 0;
+                for(index_t t=0; t<ksize; ++t)
+                {
+                    index_t i = l - left + t;
+                    if(!adjust_index_near_border(i, size, left_padding, right_padding))
+                    {
+                        continue; // zero_padding
+                    }
+                    rows[taps] = &in(i,0);
+                    weights[taps] = rev_kernel(t);
+                    ++taps;
+                }
+                if(use_simd && taps > 0)
+                {
+                    strided_column_row(simd_types(), rows, weights, taps, width, &out(j,0));
+                    continue;
+                }
+                T2 * dest = &out(j,0);
+                for(index_t k=0; k<width; ++k)
+                {
+                    weight_type sum = weight_type();
+                    for(index_t t=0; t<taps; ++t)
+                    {
+                        sum += weights[t]*rows[t][k*ss];
+                    }
+                    dest[k*ds] = sum;
+                }
+            }
+        }
+
+        template <class T>
+        void strided_column_row(std::true_type, std::vector<T const *> const & rows,
+                                std::vector<T> const & weights, index_t taps,
+                                index_t width, T * dest) const
+        {
+            detail::simd_column_row(rows.data(), weights.data(), taps, width, dest);
+        }
+
+        template <class T1, class W, class T2>
+        void strided_column_row(std::false_type, std::vector<T1 const *> const &,
+                                std::vector<W> const &, index_t, index_t, T2 *) const
+        {
+            vigra_fail("internal error: invalid call to SIMD function.");
+        }
+
+            // SIMD column convolution: the input rows contributing to output row 'j'
+            // are gathered first, so that simd_column_row() can accumulate all taps
+            // in registers instead of updating the output row once per tap
+        template <class T, class Kernel>
+        void convolve_columns_blocked(std::true_type, view_nd<T, 2> const & in, view_nd<T, 2> out,
+                                      Kernel const & rev_kernel, index_t left, index_t right,
+                                      index_t start, index_t end,
+                                      padding_mode left_padding, padding_mode right_padding) const
+        {
+            std::vector<T const *> rows(left+right+1);
+            std::vector<T> weights(left+right+1);
+            for(index_t j=start; j<end; ++j)
+            {
+                rows[0] = &in(j,0);
+                weights[0] = rev_kernel(left);
+                index_t taps = 1;
+                for(index_t k=-left; k<=right; ++k)
+                {
+                    index_t i = j + k;
+                    if(k == 0 || !adjust_index_near_border(i, in.shape(0), left_padding, right_padding))
+                    {
+                        continue; // center tap or zero_padding
+                    }
+                    rows[taps] = &in(i,0);
+                    weights[taps] = rev_kernel(k+left);
+                    ++taps;
+                }
+                detail::simd_column_row(rows.data(), weights.data(), taps, in.shape(1), &out(j,0));
+            }
+        }
+
+        template <class T1, class T2, class Kernel>
+        void convolve_columns_blocked(std::false_type, view_nd<T1, 2> const &, view_nd<T2, 2>,
+                                      Kernel const &, index_t, index_t, index_t, index_t,
+                                      padding_mode, padding_mode) const
+        {
+            vigra_fail("internal error: invalid call to SIMD function.");
+        }
+
+            // Row convolution with a kernel of compile-time size K: the taps are
+            // fully unrolled and the coefficients stay in registers, so that each
+            // output sample is computed in a single pass. Only the pixels within
+            // K/2 of the row ends need the padding rules.
+        template <index_t K, class T1, class T2, class Kernel>
+        void convolve_row_fixed(view_nd<T1, 1> const & in, view_nd<T2, 1> out,
+                                Kernel const & rev_kernel, index_t left,
+                                index_t start, index_t end,
+                                padding_mode left_padding, padding_mode right_padding) const
+        {
+            using weight_type = std::common_type_t<std::decay_t<decltype(rev_kernel(0))>,
+                                                   std::remove_const_t<T1>>;
+            weight_type w[K];
+            for(index_t t=0; t<K; ++t)
+            {
+                w[t] = rev_kernel(t);
+            }
+
+            index_t size = in.shape(0),
+                    ss   = in.strides(0),
+                    ds   = out.strides(0);
+            T1 const * src  = in.raw_data();
+            T2       * dest = out.raw_data();
+            index_t lo = std::max(start, left),
+                    hi = std::max(lo, std::min(end, size - (K - 1 - left)));
+
+            for(index_t l=start; l<end; ++l)
+            {
+                if(l == lo && lo < hi)
+                {
+                    l = hi - 1;
+                    continue;
+                }
+                weight_type sum = weight_type();
+                for(index_t t=0; t<K; ++t)
+                {
+                    index_t i = l - left + t;
+                    if(adjust_index_near_border(i, size, left_padding, right_padding))
+                    {
+                        sum += w[t]*src[i*ss];
+                    }
+                }
+                dest[l*ds] = sum;
+            }
+
+            if(ss == 1 && ds == 1)
+            {
+                for(index_t l=lo; l<hi; ++l)
+                {
+                    T1 const * p = src + l - left;
+                    weight_type sum = w[0]*p[0];
+                    for(index_t t=1; t<K; ++t)
+                    {
+                        sum += w[t]*p[t];
+                    }
+                    dest[l] = sum;
+                }
+            }
+            else
+            {
+                for(index_t l=lo; l<hi; ++l)
+                {
+                    T1 const * p = src + (l - left)*ss;
+                    weight_type sum = w[0]*p[0];
+                    for(index_t t=1; t<K; ++t)
+                    {
+                        sum += w[t]*p[t*ss];
+                    }
+                    dest[l*ds] = sum;
+                }
+            }
+        }
+
+            // Column convolution with a kernel of compile-time size K: the K input
+            // rows contributing to an output row are combined in a single pass.
+            // Rows beyond a zero-padded border get weight zero.
+        template <index_t K, class T1, class T2, class Kernel>
+        void convolve_columns_fixed(view_nd<T1, 2> const & in, view_nd<T2, 2> out,
+                                    Kernel const & rev_kernel, index_t left,
+                                    index_t start, index_t end,
+                                    padding_mode left_padding, padding_mode right_padding) const
+        {
+            using weight_type = std::common_type_t<std::decay_t<decltype(rev_kernel(0))>,
+                                                   std::remove_const_t<T1>>;
+            index_t width = in.shape(1),
+                    ss    = in.strides(1),
+                    ds    = out.strides(1);
+            for(index_t j=start; j<end; ++j)
+            {
+                T1 const * rows[K];
+                weight_type w[K];
+                for(index_t t=0; t<K; ++t)
+                {
+                    index_t i = j - left + t;
+                    bool inside = adjust_index_near_border(i, in.shape(0), left_padding, right_padding);
+                    rows[t] = &in(inside ? i : j, 0);
+                    w[t] = inside ? weight_type(rev_kernel(t)) : weight_type();
+                }
+                T2 * dest = &out(j, 0);
+                if(ss == 1 && ds == 1)
+                {
+                    for(index_t l=0; l<width; ++l)
+                    {
+                        weight_type sum = w[0]*rows[0][l];
+                        for(index_t t=1; t<K; ++t)
+                        {
+                            sum += w[t]*rows[t][l];
+                        }
+                        dest[l] = sum;
+                    }
+                }
+                else
+                {
+                    for(index_t l=0; l<width; ++l)
+                    {
+                        weight_type sum = w[0]*rows[0][l*ss];
+                        for(index_t t=1; t<K; ++t)
+                        {
+                            sum += w[t]*rows[t][l*ss];
+                        }
+                        dest[l*ds] = sum;
+                    }
+                }
+            }
+        }
     };
 
     namespace
@@ -0,0 +1,333 @@
+/************************************************************************/
+/*                                                                      */
+/*     Copyright 2017-2018 by Ullrich Koethe                            */
+/*                                                                      */
+/*    This file is part of the XVIGRA image analysis library.           */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+
+#ifndef XVIGRA_SIMD_DISPATCH_HPP
+#define XVIGRA_SIMD_DISPATCH_HPP
+
+#include <atomic>
+#include "global.hpp"
+
+/*
+    Runtime selection of the instruction set for the hot inner loops.
+
+    XVIGRA_USE_SIMD compiles the whole program with '-march=native', so that
+    the resulting binaries only run on CPUs like the build host. When
+    XVIGRA_USE_SIMD_DISPATCH is defined instead (CMake option USE_SIMD_DISPATCH),
+    the row kernels below are compiled once per instruction set (SSE4.2, AVX2+FMA,
+    AVX-512) and the best variant supported by the executing CPU is chosen
+    at startup. The remaining code is compiled for the baseline architecture.
+
+    The choice can be restricted via set_simd_isa(), e.g. to compare variants
+    in benchmarks. On compilers and platforms without function multiversioning,
+    only the scalar kernels are available.
+*/
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#  define XVIGRA_HAS_CPU_DISPATCH 1
+#  define XVIGRA_TARGET(ISA) __attribute__((target(ISA)))
+#else
+#  define XVIGRA_HAS_CPU_DISPATCH 0
+#  define XVIGRA_TARGET(ISA)
+#endif
+
+namespace xvigra
+{
+    /************/
+    /* simd_isa */
+    /************/
+
+    enum simd_isa
+    {
+        scalar_isa,
+        sse42_isa,
+        avx2_isa,
+        avx512_isa
+    };
+
+    inline char const * simd_isa_name(simd_isa isa)
+    {
+        switch(isa)
+        {
+            case sse42_isa:  return "sse4.2";
+            case avx2_isa:   return "avx2";
+            case avx512_isa: return "avx512";
+            default:         return "scalar";
+        }
+    }
+
+        // best instruction set supported by the executing CPU
+    inline simd_isa detected_simd_isa()
+    {
+    #if XVIGRA_HAS_CPU_DISPATCH
+        static const simd_isa isa = []()
+        {
+            __builtin_cpu_init();
+            if(__builtin_cpu_supports("avx512f"))
+                return avx512_isa;
+            if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+                return avx2_isa;
+            if(__builtin_cpu_supports("sse4.2"))
+                return sse42_isa;
+            return scalar_isa;
+        }();
+        return isa;
+    #else
+        return scalar_isa;
+    #endif
+    }
+
+    namespace detail
+    {
+        inline std::atomic<int> & current_simd_isa()
+        {
+            static std::atomic<int> isa(detected_simd_isa());
+            return isa;
+        }
+    }
+
+        // instruction set currently used by the dispatched kernels
+    inline simd_isa active_simd_isa()
+    {
+        return (simd_isa)detail::current_simd_isa().load(std::memory_order_relaxed);
+    }
+
+        // restrict the kernels to 'isa' (clamped to the detected instruction set),
+        // returns the previous setting
+    inline simd_isa set_simd_isa(simd_isa isa)
+    {
+        if(isa > detected_simd_isa())
+        {
+            isa = detected_simd_isa();
+        }
+        return (simd_isa)detail::current_simd_isa().exchange(isa);
+    }
+
+    /********************/
+    /* dispatch kernels */
+    /********************/
+
+    namespace detail
+    {
+        inline bool is_aligned(void const * p, std::size_t bytes)
+        {
+            return ((std::size_t)p & (bytes - 1)) == 0;
+        }
+
+    #if defined(__GNUC__) || defined(__clang__)
+        #define XVIGRA_ASSUME_ALIGNED(P, BYTES) \
+            static_cast<decltype(P)>(__builtin_assume_aligned(P, BYTES))
+    #else
+        #define XVIGRA_ASSUME_ALIGNED(P, BYTES) P
+    #endif
+
+            // The loops are written such that the compiler's auto-vectorizer
+            // produces the SIMD code for each target. Templates cannot use
+            // 'target_clones', so the variants are instantiated explicitly
+            // and selected via a function pointer table.
+        #define XVIGRA_DISPATCH_KERNELS(NAME, TARGET, STRIP)                            \
+        struct NAME                                                                    \
+        {                                                                              \
+                /* aligned rows (e.g. of aligned temporaries) need no peeling */       \
+            template <class T>                                                         \
+            TARGET static void mul_row(T const * src, index_t size, T * dest, T a)     \
+            {                                                                          \
+                if(is_aligned(src, STRIP/4) && is_aligned(dest, STRIP/4))              \
+                {                                                                      \
+                    T const * s = XVIGRA_ASSUME_ALIGNED(src, STRIP/4);                 \
+                    T * d = XVIGRA_ASSUME_ALIGNED(dest, STRIP/4);                      \
+                    for(index_t j=0; j<size; ++j)                                      \
+                        d[j] = s[j] * a;                                               \
+                }                                                                      \
+                else                                                                   \
+                {                                                                      \
+                    for(index_t j=0; j<size; ++j)                                      \
+                        dest[j] = src[j] * a;                                          \
+                }                                                                      \
+            }                                                                          \
+                                                                                       \
+            template <class T>                                                         \
+            TARGET static void fma_row(T const * src, index_t size, T * dest, T a)     \
+            {                                                                          \
+                if(is_aligned(src, STRIP/4) && is_aligned(dest, STRIP/4))              \
+                {                                                                      \
+                    T const * s = XVIGRA_ASSUME_ALIGNED(src, STRIP/4);                 \
+                    T * d = XVIGRA_ASSUME_ALIGNED(dest, STRIP/4);                      \
+                    for(index_t j=0; j<size; ++j)                                      \
+                        d[j] += s[j] * a;                                              \
+                }                                                                      \
+                else                                                                   \
+                {                                                                      \
+                    for(index_t j=0; j<size; ++j)                                      \
+                        dest[j] += src[j] * a;                                         \
+                }                                                                      \
+            }                                                                          \
+                                                                                       \
+                /* dest[j] = sum_t weights[t] * rows[t][j], computed in strips of  */  \
+                /* STRIP bytes whose accumulators stay in registers over all taps  */  \
+            template <class T>                                                         \
+            TARGET static void column_row(T const * const * rows, T const * weights,   \
+                                          index_t taps, index_t size, T * dest)        \
+            {                                                                          \
+                constexpr index_t strip = STRIP / sizeof(T);                           \
+                index_t j = 0;                                                         \
+                for(; j + strip <= size; j += strip)                                   \
+                {                                                                      \
+                    T acc[strip];                                                      \
+                    for(index_t s=0; s<strip; ++s)                                     \
+                        acc[s] = rows[0][j+s] * weights[0];                            \
+                    for(index_t t=1; t<taps; ++t)                                      \
+                    {                                                                  \
+                        T const * row = rows[t] + j;                                   \
+                        T w = weights[t];                                              \
+                        for(index_t s=0; s<strip; ++s)                                 \
+                            acc[s] += row[s] * w;                                      \
+                    }                                                                  \
+                    for(index_t s=0; s<strip; ++s)                                     \
+                        dest[j+s] = acc[s];                                            \
+                }                                                                      \
+                for(; j<size; ++j)                                                     \
+                {                                                                      \
+                    T acc = rows[0][j] * weights[0];                                   \
+                    for(index_t t=1; t<taps; ++t)                                      \
+                        acc += rows[t][j] * weights[t];                                \
+                    dest[j] = acc;                                                     \
+                }                                                                      \
+            }                                                                          \
+                                                                                       \
+            template <class T>                                                         \
+            TARGET static void parabola_row(T * dest, index_t begin, index_t end,      \
+                                            double sigma2, double center, double apex) \
+            {                                                                          \
+                for(index_t k=begin; k<end; ++k)                                       \
+                {                                                                      \
+                    double d = (double)k - center;                                     \
+                    dest[k] = static_cast<T>(sigma2 * d * d + apex);                   \
+                }                                                                      \
+            }                                                                          \
+        };
+
+            // the strip width corresponds to four SIMD registers
+        XVIGRA_DISPATCH_KERNELS(scalar_kernels, , 64)
+    #if XVIGRA_HAS_CPU_DISPATCH
+        XVIGRA_DISPATCH_KERNELS(sse42_kernels,  XVIGRA_TARGET("sse4.2"), 64)
+        XVIGRA_DISPATCH_KERNELS(avx2_kernels,   XVIGRA_TARGET("avx2,fma"), 128)
+        XVIGRA_DISPATCH_KERNELS(avx512_kernels, XVIGRA_TARGET("avx512f,avx2,fma"), 256)
+    #endif
+
+        #undef XVIGRA_DISPATCH_KERNELS
+        #undef XVIGRA_ASSUME_ALIGNED
+
+        template <class T>
+        struct dispatch_kernel_table
+        {
+            void (*mul_row)(T const *, index_t, T *, T);
+            void (*fma_row)(T const *, index_t, T *, T);
+            void (*column_row)(T const * const *, T const *, index_t, index_t, T *);
+            void (*parabola_row)(T *, index_t, index_t, double, double, double);
+        };
+
+        template <class T>
+        inline dispatch_kernel_table<T> const & dispatch_kernels(simd_isa isa)
+        {
+            using table = dispatch_kernel_table<T>;
+            static const table tables[] = {
+                table{&scalar_kernels::mul_row<T>, &scalar_kernels::fma_row<T>,
+                        &scalar_kernels::column_row<T>, &scalar_kernels::parabola_row<T>},
+        #if XVIGRA_HAS_CPU_DISPATCH
+                table{&sse42_kernels::mul_row<T>, &sse42_kernels::fma_row<T>,
+                        &sse42_kernels::column_row<T>, &sse42_kernels::parabola_row<T>},
+                table{&avx2_kernels::mul_row<T>, &avx2_kernels::fma_row<T>,
+                        &avx2_kernels::column_row<T>, &avx2_kernels::parabola_row<T>},
+                table{&avx512_kernels::mul_row<T>, &avx512_kernels::fma_row<T>,
+                        &avx512_kernels::column_row<T>, &avx512_kernels::parabola_row<T>}
+        #endif
+            };
+            return tables[XVIGRA_HAS_CPU_DISPATCH ? isa : 0];
+        }
+
+        template <class T>
+        inline dispatch_kernel_table<T> const & dispatch_kernels()
+        {
+            return dispatch_kernels<T>(active_simd_isa());
+        }
+
+            // dest[j] = src[j] * a
+        inline void dispatch_mul_row(float const * src, index_t size, float * dest, float a)
+        {
+            dispatch_kernels<float>().mul_row(src, size, dest, a);
+        }
+
+        inline void dispatch_mul_row(double const * src, index_t size, double * dest, double a)
+        {
+            dispatch_kernels<double>().mul_row(src, size, dest, a);
+        }
+
+            // dest[j] += src[j] * a
+        inline void dispatch_fma_row(float const * src, index_t size, float * dest, float a)
+        {
+            dispatch_kernels<float>().fma_row(src, size, dest, a);
+        }
+
+        inline void dispatch_fma_row(double const * src, index_t size, double * dest, double a)
+        {
+            dispatch_kernels<double>().fma_row(src, size, dest, a);
+        }
+
+            // dest[j] = sum_t weights[t] * rows[t][j] for t in [0, taps)
+        inline void dispatch_column_row(float const * const * rows, float const * weights,
+                                        index_t taps, index_t size, float * dest)
+        {
+            dispatch_kernels<float>().column_row(rows, weights, taps, size, dest);
+        }
+
+        inline void dispatch_column_row(double const * const * rows, double const * weights,
+                                        index_t taps, index_t size, double * dest)
+        {
+            dispatch_kernels<double>().column_row(rows, weights, taps, size, dest);
+        }
+
+            // dest[k] = sigma2 * (k - center)^2 + apex for k in [begin, end)
+        inline void dispatch_parabola_row(float * dest, index_t begin, index_t end,
+                                          double sigma2, double center, double apex)
+        {
+            dispatch_kernels<float>().parabola_row(dest, begin, end, sigma2, center, apex);
+        }
+
+        inline void dispatch_parabola_row(double * dest, index_t begin, index_t end,
+                                          double sigma2, double center, double apex)
+        {
+            dispatch_kernels<double>().parabola_row(dest, begin, end, sigma2, center, apex);
+        }
+    } // namespace detail
+
+} // namespace xvigra
+
+#endif // XVIGRA_SIMD_DISPATCH_HPP
@@ -39,6 +39,10 @@
 #include "concepts.hpp"
 #include "math.hpp"
 
+#ifdef XVIGRA_USE_SIMD
+#  include <xsimd/xsimd.hpp>
+#endif
+
 namespace xvigra
 {
     /***********************/
@@ -2947,6 +2951,141 @@ namespace xvigra
     {
         return std::pow(norm_lp_to_p(t, p), 1.0 / p);
     }
+
+#ifdef XVIGRA_USE_SIMD
+
+    /***********************************/
+    /* SIMD arithmetic for tiny_vector */
+    /***********************************/
+
+    // Small float/double tiny_vectors are mapped onto a single xsimd batch.
+    // Size 3 (the typical RGB pixel or 3D gradient) is padded to 4 lanes
+    // with zeros, or with ones for a divisor (to avoid raising FE_INVALID).
+    // The following overloads are more specialized than the generic ones
+    // above and are therefore preferred by overload resolution.
+
+    namespace tiny_detail
+    {
+        template <class V, index_t N>
+        struct simd_lanes
+        {
+            static const index_t value = 0;
+        };
+
+    #if XSIMD_BATCH_FLOAT_SIZE >= 4
+        template <> struct simd_lanes<float, 3> { static const index_t value = 4; };
+        template <> struct simd_lanes<float, 4> { static const index_t value = 4; };
+    #endif
+    #if XSIMD_BATCH_FLOAT_SIZE >= 8
+        template <> struct simd_lanes<float, 8> { static const index_t value = 8; };
+    #endif
+    #if XSIMD_BATCH_DOUBLE_SIZE >= 2
+        template <> struct simd_lanes<double, 2> { static const index_t value = 2; };
+    #endif
+    #if XSIMD_BATCH_DOUBLE_SIZE >= 4
+        template <> struct simd_lanes<double, 3> { static const index_t value = 4; };
+        template <> struct simd_lanes<double, 4> { static const index_t value = 4; };
+    #endif
+    #if XSIMD_BATCH_DOUBLE_SIZE >= 8
+        template <> struct simd_lanes<double, 8> { static const index_t value = 8; };
+    #endif
+
+        template <class V, index_t N>
+        using simd_batch_t = xsimd::batch<V, simd_lanes<V, N>::value>;
+
+        template <class V, index_t N>
+        inline simd_batch_t<V, N>
+        simd_load(tiny_vector<V, N> const & v, V pad = V())
+        {
+            simd_batch_t<V, N> res;
+            if(N == simd_lanes<V, N>::value)
+            {
+                res.load_unaligned(v.data());
+            }
+            else
+            {
+                V buffer[simd_lanes<V, N>::value];
+                std::fill(buffer + N, buffer + simd_lanes<V, N>::value, pad);
+                std::copy(v.begin(), v.end(), buffer);
+                res.load_unaligned(buffer);
+            }
+            return res;
+        }
+
+        template <class V, index_t N>
+        inline tiny_vector<V, N>
+        simd_store(simd_batch_t<V, N> const & b)
+        {
+            tiny_vector<V, N> res(dont_init);
+            if(N == simd_lanes<V, N>::value)
+            {
+                b.store_unaligned(res.data());
+            }
+            else
+            {
+                V buffer[simd_lanes<V, N>::value];
+                b.store_unaligned(buffer);
+                std::copy(buffer, buffer + N, res.begin());
+            }
+            return res;
+        }
+    } // namespace tiny_detail
+
+    #define XVIGRA_TINYARRAY_SIMD_OPERATOR(OP, PAD)                               \
+    template <class V, index_t N,                                                 \
+              VIGRA_REQUIRE<tiny_detail::simd_lanes<V, N>::value != 0>>           \
+    inline tiny_vector<V, N>                                                      \
+    operator OP(tiny_vector<V, N> const & l, tiny_vector<V, N> const & r)         \
+    {                                                                             \
+        using namespace tiny_detail;                                              \
+        return simd_store<V, N>(simd_load(l) OP simd_load(r, V(PAD)));            \
+    }
+
+    XVIGRA_TINYARRAY_SIMD_OPERATOR(+, 0)
+    XVIGRA_TINYARRAY_SIMD_OPERATOR(-, 0)
+    XVIGRA_TINYARRAY_SIMD_OPERATOR(*, 0)
+    XVIGRA_TINYARRAY_SIMD_OPERATOR(/, 1)
+
+    #undef XVIGRA_TINYARRAY_SIMD_OPERATOR
+
+    #define XVIGRA_TINYARRAY_SIMD_FUNCTION(NAME)                                   \
+    template <class V, index_t N,                                                 \
+              VIGRA_REQUIRE<tiny_detail::simd_lanes<V, N>::value != 0>>           \
+    inline tiny_vector<V, N>                                                      \
+    NAME(tiny_vector<V, N> const & l, tiny_vector<V, N> const & r)                \
+    {                                                                             \
+        using namespace tiny_detail;                                              \
+        return simd_store<V, N>(xsimd::NAME(simd_load(l), simd_load(r)));         \
+    }
+
+    XVIGRA_TINYARRAY_SIMD_FUNCTION(min)
+    XVIGRA_TINYARRAY_SIMD_FUNCTION(max)
+
+    #undef XVIGRA_TINYARRAY_SIMD_FUNCTION
+
+        /// dot product of two float or double tiny_vectors (SIMD version)
+    template <class V, index_t N,
+              VIGRA_REQUIRE<tiny_detail::simd_lanes<V, N>::value != 0>>
+    inline V
+    dot(tiny_vector<V, N> const & l, tiny_vector<V, N> const & r)
+    {
+        using namespace tiny_detail;
+        return xsimd::hadd(simd_load(l) * simd_load(r));
+    }
+
+        /// squared norm of a float or double tiny_vector (SIMD version)
+    template <class V, index_t N,
+              VIGRA_REQUIRE<tiny_detail::simd_lanes<V, N>::value != 0>>
+    inline auto
+    norm_sq(tiny_vector<V, N> const & t) noexcept
+    {
+        using namespace tiny_detail;
+        using result_type = squared_norm_type_t<tiny_vector<V, N>>;
+        auto b = simd_load(t);
+        return static_cast<result_type>(xsimd::hadd(b * b));
+    }
+
+#endif // XVIGRA_USE_SIMD
 //@}
 
 } // namespace xvigra
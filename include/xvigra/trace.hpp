@@ -0,0 +1,259 @@
+/************************************************************************/
+/*                                                                      */
+/*     Copyright 2017-2018 by Ullrich Koethe                            */
+/*                                                                      */
+/*    This file is part of the XVIGRA image analysis library.           */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+
+#ifndef XVIGRA_TRACE_HPP
+#define XVIGRA_TRACE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include "global.hpp"
+#include "error.hpp"
+
+/*
+    Pluggable tracing of functor calls and their internal stages.
+
+    When XVIGRA_ENABLE_TRACING is defined (CMake option ENABLE_TRACING), functors
+    emit a begin/end event pair for every call (category "functor") and for
+    their internal stages such as axis passes and temporary allocations
+    (category "stage") to the currently installed trace_sink. The
+    chrome_trace_sink writes these events in Chrome's trace event format,
+    which can be inspected in chrome://tracing or https://ui.perfetto.dev:
+
+        chrome_trace_sink sink("pipeline.json");
+        set_trace_sink(&sink);
+        ... // run the pipeline
+        set_trace_sink(nullptr);
+
+    Without XVIGRA_ENABLE_TRACING, the XVIGRA_TRACE_SCOPE macro expands to nothing.
+*/
+
+namespace xvigra
+{
+    /**************/
+    /* trace_sink */
+    /**************/
+
+        /** Receiver of trace events. Implementations must be thread-safe,
+            because functors may be called from several threads.
+        */
+    class trace_sink
+    {
+      public:
+        virtual ~trace_sink() {}
+
+        virtual void begin(std::string const & name, char const * category) = 0;
+        virtual void end(std::string const & name, char const * category) = 0;
+    };
+
+    namespace detail
+    {
+        inline std::atomic<trace_sink *> & current_trace_sink()
+        {
+            static std::atomic<trace_sink *> sink(nullptr);
+            return sink;
+        }
+    }
+
+        // install a sink (pass nullptr to disable tracing), returns the previous sink
+    inline trace_sink * set_trace_sink(trace_sink * sink)
+    {
+        return detail::current_trace_sink().exchange(sink);
+    }
+
+    inline trace_sink * get_trace_sink()
+    {
+        return detail::current_trace_sink().load(std::memory_order_acquire);
+    }
+
+    /*********************/
+    /* chrome_trace_sink */
+    /*********************/
+
+    namespace detail
+    {
+            // quote a string for a JSON string literal
+        inline std::string escape_json(std::string const & s)
+        {
+            static const char hex[] = "0123456789abcdef";
+            std::string res;
+            res.reserve(s.size());
+            for(char c: s)
+            {
+                switch(c)
+                {
+                  case '"':  res += "\\\""; break;
+                  case '\\': res += "\\\\"; break;
+                  case '\b': res += "\\b"; break;
+                  case '\f': res += "\\f"; break;
+                  case '\n': res += "\\n"; break;
+                  case '\r': res += "\\r"; break;
+                  case '\t': res += "\\t"; break;
+                  default:
+                    if(static_cast<unsigned char>(c) < 0x20)
+                    {
+                        res += "\\u00";
+                        res += hex[(c >> 4) & 0xf];
+                        res += hex[c & 0xf];
+                    }
+                    else
+                    {
+                        res += c;
+                    }
+                }
+            }
+            return res;
+        }
+    }
+
+        /** Write trace events as a JSON array in Chrome's trace event format.
+            Timestamps are measured in microseconds since the creation of the sink.
+        */
+    class chrome_trace_sink
+    : public trace_sink
+    {
+      public:
+        explicit
+        chrome_trace_sink(std::ostream & out)
+        : out_(&out)
+        , first_(true)
+        , start_(std::chrono::steady_clock::now())
+        {
+            *out_ << "[";
+        }
+
+        explicit
+        chrome_trace_sink(std::string const & filename)
+        : file_(new std::ofstream(filename))
+        , out_(file_.get())
+        , first_(true)
+        , start_(std::chrono::steady_clock::now())
+        {
+            vigra_precondition(!!*file_,
+                "chrome_trace_sink(): Unable to open file '" + filename + "' for writing.");
+            *out_ << "[";
+        }
+
+        ~chrome_trace_sink()
+        {
+            *out_ << "\n]\n";
+            out_->flush();
+        }
+
+        void begin(std::string const & name, char const * category) override
+        {
+            write(name, category, 'B');
+        }
+
+        void end(std::string const & name, char const * category) override
+        {
+            write(name, category, 'E');
+        }
+
+      private:
+        void write(std::string const & name, char const * category, char phase)
+        {
+            double ts = std::chrono::duration<double, std::micro>(
+                            std::chrono::steady_clock::now() - start_).count();
+            std::lock_guard<std::mutex> guard(lock_);
+            auto tid = threads_.emplace(std::this_thread::get_id(), threads_.size()).first->second;
+            *out_ << (first_ ? "\n" : ",\n")
+                  << "{\"name\": \"" << detail::escape_json(name)
+                  << "\", \"cat\": \"" << detail::escape_json(category)
+                  << "\", \"ph\": \"" << phase << "\", \"ts\": " << std::to_string(ts)
+                  << ", \"pid\": 0, \"tid\": " << tid << "}";
+            first_ = false;
+        }
+
+        std::unique_ptr<std::ofstream> file_;
+        std::ostream * out_;
+        bool first_;
+        std::chrono::steady_clock::time_point start_;
+        std::map<std::thread::id, std::size_t> threads_;
+        std::mutex lock_;
+    };
+
+    /****************/
+    /* scoped_trace */
+    /****************/
+
+        /** Emit a begin event on construction and the matching end event on
+            destruction to the sink that was installed at construction time.
+        */
+    class scoped_trace
+    {
+      public:
+        scoped_trace(std::string name, char const * category = "stage")
+        : sink_(get_trace_sink())
+        , name_(std::move(name))
+        , category_(category)
+        {
+            if(sink_)
+                sink_->begin(name_, category_);
+        }
+
+        ~scoped_trace()
+        {
+            if(sink_)
+                sink_->end(name_, category_);
+        }
+
+        scoped_trace(scoped_trace const &) = delete;
+        scoped_trace & operator=(scoped_trace const &) = delete;
+
+      private:
+        trace_sink * sink_;
+        std::string name_;
+        char const * category_;
+    };
+
+} // namespace xvigra
+
+#define XVIGRA_TRACE_CONCAT_IMPL(A, B) A##B
+#define XVIGRA_TRACE_CONCAT(A, B) XVIGRA_TRACE_CONCAT_IMPL(A, B)
+
+#ifdef XVIGRA_ENABLE_TRACING
+    // 'NAME' is only evaluated when a sink is installed
+    #define XVIGRA_TRACE_SCOPE(NAME, CATEGORY)                                         \
+        ::xvigra::scoped_trace XVIGRA_TRACE_CONCAT(xvigra_trace_scope_, __LINE__)(     \
+            ::xvigra::get_trace_sink() ? std::string(NAME) : std::string(), CATEGORY)
+#else
+    #define XVIGRA_TRACE_SCOPE(NAME, CATEGORY)
+#endif
+
+#endif // XVIGRA_TRACE_HPP
@@ -0,0 +1,96 @@
+/************************************************************************/
+/*                                                                      */
+/*     Copyright 2017-2018 by Ullrich Koethe                            */
+/*                                                                      */
+/*    This file is part of the XVIGRA image analysis library.           */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+#include <numeric>
+#include <vector>
+#include "unittest.hpp"
+#include <xvigra/array_io.hpp>
+
+namespace xvigra
+{
+    TEST(array_io, npy)
+    {
+        std::vector<float> data(4*5*6);
+        std::iota(data.begin(), data.end(), 0.0f);
+        array_nd<float, 3> a(shape_t<3>{4, 5, 6}, data.begin(), data.end());
+
+        write_npy("array_io_test.npy", a);
+        EXPECT_EQ(read_npy_shape("array_io_test.npy"), shape_t<>(a.shape()));
+        EXPECT_TRUE(read_npy<float>("array_io_test.npy") == a);
+        EXPECT_TRUE(mapped_array<float, 3>("array_io_test.npy").view() == a);
+
+        // strided source and destination
+        write_npy("array_io_test.npy", a.transpose());
+        array_nd<float, 3> b(a.shape());
+        read_npy_into("array_io_test.npy", b.transpose());
+        EXPECT_TRUE(b == a);
+
+        EXPECT_THROW(read_npy<double>("array_io_test.npy"), std::runtime_error);
+    }
+
+    TEST(array_io, npy_shape)
+    {
+        // the shape in the header must round-trip for any dimension
+        array_nd<int32_t, 1> a1(shape_t<1>{7}, 3);
+        write_npy("array_io_test.npy", a1);
+        EXPECT_EQ(read_npy_shape("array_io_test.npy"), (shape_t<>{7}));
+        EXPECT_TRUE(read_npy<int32_t>("array_io_test.npy") == a1);
+
+        array_nd<uint8_t, 2> a2(shape_t<2>{3, 11}, 1);
+        write_npy("array_io_test.npy", a2);
+        EXPECT_EQ(read_npy_shape("array_io_test.npy"), (shape_t<>{3, 11}));
+
+        array_nd<double> a4(shape_t<>{2, 1, 4, 3}, 0.5);
+        write_npy("array_io_test.npy", a4);
+        EXPECT_EQ(read_npy_shape("array_io_test.npy"), a4.shape());
+        EXPECT_TRUE(read_npy<double>("array_io_test.npy") == a4);
+    }
+
+    TEST(array_io, chunked)
+    {
+        std::vector<uint16_t> data(9*20*7*2);
+        std::iota(data.begin(), data.end(), 0);
+        array_nd<uint16_t> a(shape_t<>{9, 20, 7, 2}, data.begin(), data.end());
+
+        auto options = chunked_options().chunks(shape_t<>{4, 8, 8, 1}).thread_count(3);
+        write_chunked("array_io_test.xvc", a, options);
+        EXPECT_EQ(read_chunked_shape("array_io_test.xvc"), a.shape());
+        EXPECT_TRUE(read_chunked<uint16_t>("array_io_test.xvc") == a);
+
+        array_nd<uint16_t, 4> b(shape_t<4>{2, 7, 20, 9});
+        read_chunked_into("array_io_test.xvc", b.transpose(), 2);
+        EXPECT_TRUE(b.transpose() == a);
+
+#ifdef XVIGRA_USE_ZLIB
+        write_chunked("array_io_test.xvc", a, options.compress(chunk_compression::zlib));
+        EXPECT_TRUE(read_chunked<uint16_t>("array_io_test.xvc") == a);
+#endif
+    }
+} // namespace xvigra
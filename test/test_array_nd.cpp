@@ -1060,4 +1060,145 @@ namespace xvigra
         EXPECT_EQ(vsized.dimension(), 4);
     }
 #endif
+
+    TEST(array_nd, line_iterator)
+    {
+        array_nd<int, 3> a(s);
+        std::iota(a.begin(), a.end(), 0);
+
+        for(index_t axis=0; axis<3; ++axis)
+        {
+            slicer nav(s);
+            nav.set_free_axes(axis);
+            auto line = a.lines(axis);
+            EXPECT_EQ(line.size(), prod(s) / s[axis]);
+            for(; nav.has_more(); ++nav, ++line)
+            {
+                EXPECT_TRUE(line.has_more());
+                EXPECT_EQ(line.length(), s[axis]);
+                EXPECT_EQ(line.stride(), a.strides(axis));
+                EXPECT_TRUE(*line == a.view(*nav));
+            }
+            EXPECT_FALSE(line.has_more());
+        }
+
+        slicer nav(s);
+        nav.set_free_axes(shape_t<2>{0, 2});
+        auto plane = a.hyperplanes(shape_t<2>{2, 0});
+        EXPECT_EQ(plane.size(), s[1]);
+        for(; nav.has_more(); ++nav, ++plane)
+        {
+            EXPECT_EQ((*plane).shape(), (shape_t<2>{s[0], s[2]}));
+            EXPECT_TRUE(*plane == a.view(*nav));
+        }
+        EXPECT_FALSE(plane.has_more());
+
+        auto lines = a.lines(1);
+        auto sub   = lines.subrange(3, 6);
+        for(index_t i=3; i<6; ++i, ++sub)
+        {
+            EXPECT_EQ(sub.index(), i);
+            EXPECT_TRUE(*sub == lines[i]);
+        }
+        EXPECT_FALSE(sub.has_more());
+    }
+
+        // allocate buffers that start 'offset' bytes after an 'aligned_row_bytes' boundary
+    template <class T>
+    struct offset_allocator
+    {
+        using value_type = T;
+
+        template <class U>
+        struct rebind
+        {
+            using other = offset_allocator<U>;
+        };
+
+        explicit offset_allocator(std::size_t o = 0)
+        : offset(o)
+        {}
+
+        template <class U>
+        offset_allocator(offset_allocator<U> const & other)
+        : offset(other.offset)
+        {}
+
+        T * allocate(std::size_t n)
+        {
+            char * p = static_cast<char *>(::operator new(n*sizeof(T) + 2*aligned_row_bytes));
+            std::size_t shift = aligned_row_bytes - (std::size_t)p % aligned_row_bytes + offset;
+            p += shift;
+            reinterpret_cast<unsigned char *>(p)[-1] = (unsigned char)shift;
+            return reinterpret_cast<T *>(p);
+        }
+
+        void deallocate(T * p, std::size_t)
+        {
+            unsigned char * c = reinterpret_cast<unsigned char *>(p);
+            ::operator delete(c - c[-1]);
+        }
+
+        std::size_t offset;
+    };
+
+    template <class T, class U>
+    inline bool operator==(offset_allocator<T> const & l, offset_allocator<U> const & r)
+    {
+        return l.offset == r.offset;
+    }
+
+    template <class T, class U>
+    inline bool operator!=(offset_allocator<T> const & l, offset_allocator<U> const & r)
+    {
+        return l.offset != r.offset;
+    }
+
+    TEST(array_nd, aligned_rows)
+    {
+        shape_t<3> s{4, 5, 7};
+        array_nd<float, 3> dense(s);
+        for(index_t k=0; k<dense.size(); ++k)
+        {
+            dense[k] = float(k);
+        }
+
+        array_nd<float, 3> a(s, aligned_rows);
+        EXPECT_EQ(a.shape(), s);
+        EXPECT_EQ(a.strides(), (shape_t<3>{80, 16, 1}));  // 7 floats padded to 64 bytes
+        EXPECT_FALSE(a.is_contiguous());
+        EXPECT_TRUE(a.owns_memory());
+        for(index_t z=0; z<s[0]; ++z)
+        {
+            for(index_t y=0; y<s[1]; ++y)
+            {
+                EXPECT_EQ((std::size_t)&a(z, y, 0) % aligned_row_bytes, 0u);
+            }
+        }
+
+        a = dense;
+        EXPECT_TRUE(a == dense);
+
+        array_nd<float, 3> b(a);
+        EXPECT_EQ(b.strides(), a.strides());
+        EXPECT_FALSE(b.is_contiguous());
+        EXPECT_EQ((std::size_t)b.raw_data() % aligned_row_bytes, 0u);
+        EXPECT_TRUE(b == dense);
+
+        // copy padded arrays whose buffer starts at an aligned address (data offset 0)
+        // and at an unaligned one (data offset > 0)
+        for(std::size_t offset: {std::size_t(0), sizeof(float)})
+        {
+            using array_type = array_nd<float, 3, offset_allocator<float>>;
+            array_type c(s, aligned_rows, 0.0f, offset_allocator<float>(offset));
+            EXPECT_EQ((std::size_t)c.raw_data() % aligned_row_bytes, 0u);
+            c = dense;
+
+            array_type d(c);
+            EXPECT_EQ(d.strides(), c.strides());
+            EXPECT_FALSE(d.is_contiguous());
+            EXPECT_EQ((std::size_t)d.raw_data() % aligned_row_bytes, 0u);
+            EXPECT_TRUE(d == dense);
+        }
+    }
 } // namespace xvigra
@@ -0,0 +1,75 @@
+/************************************************************************/
+/*                                                                      */
+/*     Copyright 2017-2018 by Ullrich Koethe                            */
+/*                                                                      */
+/*    This file is part of the XVIGRA image analysis library.           */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+#include "unittest.hpp"
+#include <xvigra/async_image_io.hpp>
+
+namespace xvigra
+{
+    TEST(async_image_io, image_loader)
+    {
+        auto image = read_image<float>("color_image.tif");
+        std::vector<std::string> files(5, "color_image.tif");
+
+        image_loader<float> loader(files, 2);
+        index_t count = 0;
+        while(loader.has_more())
+        {
+            EXPECT_EQ(loader.index(), count);
+            EXPECT_EQ(loader.filename(), files[count]);
+            auto a = loader.next();
+            EXPECT_TRUE(a == image);
+            loader.recycle(std::move(a));
+            ++count;
+        }
+        EXPECT_EQ(count, 5);
+    }
+
+    TEST(async_image_io, image_writer)
+    {
+        auto image = read_image<float>("color_image.tif");
+        {
+            image_writer writer(2);
+            for(int k = 0; k < 3; ++k)
+            {
+                array_nd<float> result((k + 1.0f) * image);
+                writer.push("async_writer_test_" + std::to_string(k) + ".tif", std::move(result));
+            }
+            writer.push("async_writer_test_view.tif", image.bind(2, 0));
+            writer.wait();
+            EXPECT_EQ(writer.pending(), 0);
+        }
+        for(int k = 0; k < 3; ++k)
+        {
+            EXPECT_TRUE(read_image<float>("async_writer_test_" + std::to_string(k) + ".tif") == (k + 1.0f) * image);
+        }
+        EXPECT_TRUE(read_image<float>("async_writer_test_view.tif") == image.bind(2, 0));
+    }
+} // namespace xvigra
@@ -0,0 +1,182 @@
+/************************************************************************/
+/*                                                                      */
+/*     Copyright 2017-2018 by Ullrich Koethe                            */
+/*                                                                      */
+/*    This file is part of the XVIGRA image analysis library.           */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+#include "unittest.hpp"
+#include <xvigra/convolution.hpp>
+#include <xvigra/array_nd.hpp>
+
+namespace xvigra
+{
+    TEST(convolution, zero_padding)
+    {
+        array_nd<float, 2> in({13, 17}), out(in.shape(), 0), ref(in.shape(), 0),
+                           kernel({3, 5});
+        for(index_t k=0; k<in.size(); ++k)
+        {
+            in[k] = float((k*7) % 11);
+        }
+        for(index_t k=0; k<kernel.size(); ++k)
+        {
+            kernel[k] = float((k*5) % 7) - 3.0f;
+        }
+
+        // brute-force convolution with the kernel center at (1, 2)
+        for(index_t y=0; y<in.shape(0); ++y)
+        {
+            for(index_t x=0; x<in.shape(1); ++x)
+            {
+                float sum = 0.0f;
+                for(index_t ky=0; ky<3; ++ky)
+                {
+                    for(index_t kx=0; kx<5; ++kx)
+                    {
+                        index_t yy = y + 1 - ky,
+                                xx = x + 2 - kx;
+                        if(yy >= 0 && yy < in.shape(0) && xx >= 0 && xx < in.shape(1))
+                        {
+                            sum += kernel(ky, kx)*in(yy, xx);
+                        }
+                    }
+                }
+                ref(y, x) = sum;
+            }
+        }
+
+        auto options = convolution_options().padding(zero_padding);
+        convolution(in, out, kernel, options);
+        EXPECT_TRUE(allclose(out, ref));
+
+        out = 0.0f;
+        convolution(in, out, kernel, options.use_method(fft_convolution));
+        EXPECT_TRUE(allclose(out, ref, 1e-4, 1e-4));
+
+        out = 0.0f;
+        convolution(in, out, kernel, options.use_method(direct_convolution).use_simd(false));
+        EXPECT_TRUE(allclose(out, ref));
+    }
+
+    TEST(convolution, separable_kernels)
+    {
+        auto && k0 = gaussian_kernel_1d<double>(1.0, 3);
+        auto && k1 = averaging_kernel_1d<double>(2);
+        std::vector<kernel_1d<double>> kernels{k0, k1};
+        array_nd<double, 2> in({20, 30}), out(in.shape(), 0), ref(in.shape(), 0),
+                            kernel({7, 5});
+        for(index_t k=0; k<in.size(); ++k)
+        {
+            in[k] = double((k*13) % 19);
+        }
+        for(index_t y=0; y<kernel.shape(0); ++y)
+        {
+            for(index_t x=0; x<kernel.shape(1); ++x)
+            {
+                kernel(y, x) = k0(y)*k1(x);
+            }
+        }
+
+        for(padding_mode mode: {reflect_padding, periodic_padding, repeat_padding})
+        {
+            auto options = convolution_options().padding(mode);
+            separable_convolution(in, ref, kernels, options);
+            // the kernel has rank 1 and is executed by separable_convolution()
+            convolution(in, out, kernel, options);
+            EXPECT_TRUE(allclose(out, ref));
+            // direct computation
+            out = 0.0;
+            convolution(in, out, kernel, options.use_low_rank(false));
+            EXPECT_TRUE(allclose(out, ref));
+            // overlap-add FFT
+            out = 0.0;
+            convolution(in, out, kernel, options.use_method(fft_convolution));
+            EXPECT_TRUE(allclose(out, ref));
+            out = 0.0;
+            convolution(in, out, kernels, options);
+            EXPECT_TRUE(allclose(out, ref));
+        }
+    }
+
+    TEST(convolution, large_kernel)
+    {
+        // a 3D box kernel with 3375 taps is executed by FFT, using several blocks along axis 2
+        array_nd<double, 3> in({16, 18, 90}), out(in.shape(), 0), ref(in.shape(), 0),
+                            kernel({15, 15, 15}, 1.0);
+        for(index_t k=0; k<in.size(); ++k)
+        {
+            in[k] = double((k*7) % 23);
+        }
+        auto options = convolution_options().padding(reflect0_padding);
+        convolution(in, out, kernel, options);
+        separable_convolution(in, ref, averaging_kernel_1d<double>(7), options);
+        EXPECT_TRUE(allclose(out, 3375.0*ref));
+    }
+
+    TEST(convolution, input_types)
+    {
+        // integer and strided input use a padded temporary instead of padded_view
+        array_nd<int, 2> in({15, 12});
+        array_nd<float, 2> fin(in.shape()), kernel({3, 3}),
+                           out(in.shape(), 0), ref(in.shape(), 0);
+        for(index_t k=0; k<in.size(); ++k)
+        {
+            in[k] = int((k*3) % 10);
+            fin[k] = float(in[k]);
+        }
+        for(index_t k=0; k<kernel.size(); ++k)
+        {
+            kernel[k] = float(k) - 4.5f;
+        }
+        auto options = convolution_options().use_method(direct_convolution).use_low_rank(false);
+        convolution(fin, ref, kernel, options);
+        convolution(in, out, kernel, options);
+        EXPECT_TRUE(allclose(out, ref));
+
+        array_nd<float, 2> out_t({12, 15}, 0), ref_t({12, 15}, 0), fin_t(fin.transpose());
+        convolution(fin.transpose(), out_t, kernel, options);
+        convolution(fin_t, ref_t, kernel, options);
+        EXPECT_TRUE(allclose(out_t, ref_t));
+    }
+
+    TEST(convolution, no_padding)
+    {
+        array_nd<float, 3> in({6, 7, 8}), out(in.shape(), -1), ref(in.shape(), -1),
+                           kernel({3, 3, 3}, 1.0f);
+        for(index_t k=0; k<in.size(); ++k)
+        {
+            in[k] = float(k % 5);
+        }
+        convolution(in, out, kernel, convolution_options().padding(no_padding));
+        separable_convolution(in, ref, averaging_kernel_1d<float>(1),
+                              convolution_options().padding(no_padding));
+        // the averaging kernel is normalized, the box kernel is not
+        EXPECT_TRUE(allclose(out.subarray({1,1,1}, {5,6,7}), 27.0f*ref.subarray({1,1,1}, {5,6,7})));
+        EXPECT_EQ(out(0, 3, 3), -1.0f);
+        EXPECT_EQ(out(5, 6, 7), -1.0f);
+    }
+}
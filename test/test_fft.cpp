@@ -0,0 +1,86 @@
+/************************************************************************/
+/*                                                                      */
+/*     Copyright 2017-2018 by Ullrich Koethe                            */
+/*                                                                      */
+/*    This file is part of the XVIGRA image analysis library.           */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+#include "unittest.hpp"
+
+#include <xvigra/fft.hpp>
+#include <xvigra/array_nd.hpp>
+
+namespace xvigra
+{
+    TEST(fft, fourier_transform)
+    {
+        using complex_type = std::complex<double>;
+        EXPECT_EQ(fft_size(1), 1);
+        EXPECT_EQ(fft_size(33), 64);
+        EXPECT_EQ(fft_size(64), 64);
+
+        array_nd<complex_type, 2> a({4, 8}), ref(a.shape());
+        for(index_t k=0; k<a.size(); ++k)
+        {
+            a[k] = complex_type(double((k*5) % 7), double(k % 3));
+        }
+        // direct evaluation of the DFT
+        for(index_t u=0; u<4; ++u)
+        {
+            for(index_t v=0; v<8; ++v)
+            {
+                complex_type sum;
+                for(index_t y=0; y<4; ++y)
+                {
+                    for(index_t x=0; x<8; ++x)
+                    {
+                        sum += a(y, x)*std::polar(1.0, -2.0*M_PI*(double(u*y)/4.0 + double(v*x)/8.0));
+                    }
+                }
+                ref(u, v) = sum;
+            }
+        }
+
+        array_nd<complex_type, 2> f(a);
+        f.set_axistags({tags::axis_y, tags::axis_x});
+        fourier_transform(f);
+        EXPECT_EQ(f.axistags(), (tiny_vector<tags::axis_tag, 2>{tags::axis_fy, tags::axis_fx}));
+        for(index_t k=0; k<f.size(); ++k)
+        {
+            EXPECT_NEAR(std::abs(f[k] - ref[k]), 0.0, 1e-12);
+        }
+
+        // the transposed array exercises the non-contiguous lines
+        view_nd<complex_type, 2> t = f.transpose();
+        fourier_transform(t, true);
+        EXPECT_EQ(f.axistags(), (tiny_vector<tags::axis_tag, 2>{tags::axis_fy, tags::axis_fx}));
+        EXPECT_EQ(t.axistags(), (tiny_vector<tags::axis_tag, 2>{tags::axis_x, tags::axis_y}));
+        for(index_t k=0; k<f.size(); ++k)
+        {
+            EXPECT_NEAR(std::abs(f[k] - a[k]), 0.0, 1e-12);
+        }
+    }
+}
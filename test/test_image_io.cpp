@@ -0,0 +1,216 @@
+/************************************************************************/
+/*                                                                      */
+/*     Copyright 2017-2018 by Ullrich Koethe                            */
+/*                                                                      */
+/*    This file is part of the XVIGRA image analysis library.           */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+
+#include "unittest.hpp"
+#include <xvigra/image_io.hpp>
+
+namespace xvigra
+{
+    TEST(image_io, read_image_region)
+    {
+        auto info = read_image_info("color_image.tif");
+        auto image = read_image<float>("color_image.tif");
+        EXPECT_EQ(info.shape(), image.shape());
+
+        shape_t<> p{10, 20, 0},
+                  q{p[0] + 15, p[1] + 25, info.channels};
+        array_nd<float, 3> region(q - p);
+        read_image_region("color_image.tif", region, shape_t<2>{p[0], p[1]});
+        EXPECT_TRUE(region == image.subarray(p, q));
+
+        array_nd<float, 3> rows(shape_t<3>{7, info.width, info.channels});
+        read_image_region("color_image.tif", rows, shape_t<2>{3, 0});
+        EXPECT_TRUE(rows == image.subarray(shape_t<>{3, 0, 0}, shape_t<>{10, info.width, info.channels}));
+
+        array_nd<float, 2> red(shape_t<2>{15, 25});
+        read_image_region("color_image.tif", red, shape_t<2>{p[0], p[1]});
+        EXPECT_TRUE(red == image.subarray(p, q).bind(2, 0));
+    }
+
+        // write 'data' as a tiled float TIFF
+    static void write_tiled_image(std::string filename, array_nd<float, 3> const & data, int tile_size)
+    {
+        OIIO::ImageOutput * out = OIIO::ImageOutput::create(filename);
+        EXPECT_TRUE(out != nullptr);
+        if(out == nullptr)
+        {
+            return;
+        }
+        OIIO::ImageSpec spec((int)data.shape(1), (int)data.shape(0), (int)data.shape(2),
+                             OIIO::TypeDesc::FLOAT);
+        spec.tile_width  = tile_size;
+        spec.tile_height = tile_size;
+        EXPECT_TRUE(out->supports("tiles"));
+        EXPECT_TRUE(out->open(filename, spec));
+        EXPECT_TRUE(out->write_image(OIIO::TypeDesc::FLOAT, data.raw_data()));
+        out->close();
+        OIIO::ImageOutput::destroy(out);
+    }
+
+    TEST(image_io, read_image_region_tiled)
+    {
+        // 16x16 tiles, the last row and column of tiles are incomplete
+        auto image = read_image<float>("color_image.tif");
+        shape_t<3> shape{50, 70, image.shape(2)};
+        array_nd<float, 3> data(shape);
+        data = image.subarray(shape_t<>{0, 0, 0}, shape_t<>(shape));
+        write_tiled_image("read_image_region_test.tif", data, 16);
+        EXPECT_EQ(detail::open_image_input("read_image_region_test.tif", "test")->spec().tile_width, 16);
+        EXPECT_TRUE(read_image<float>("read_image_region_test.tif") == data);
+
+        // regions that are not tile-aligned, in the interior and at the lower right border
+        index_t regions[][4] = { {5, 13, 42, 61},     // y0, x0, y1, x1
+                                 {37, 3, 50, 70},
+                                 {17, 33, 18, 34} };
+        for(auto const & r : regions)
+        {
+            shape_t<3> p{r[0], r[1], 0},
+                       q{r[2], r[3], shape[2]};
+            array_nd<float, 3> region(q - p);
+            read_image_region("read_image_region_test.tif", region, shape_t<2>{p[0], p[1]});
+            EXPECT_TRUE(region == data.subarray(p, q));
+        }
+
+        // single channel of a tiled image
+        array_nd<float, 2> red(shape_t<2>{20, 30});
+        read_image_region("read_image_region_test.tif", red, shape_t<2>{9, 25});
+        EXPECT_TRUE(red == data.subarray(shape_t<3>{9, 25, 0}, shape_t<3>{29, 55, shape[2]}).bind(2, 0));
+    }
+
+    TEST(image_io, scanline_reader)
+    {
+        auto image = read_image<float>("color_image.tif");
+        index_t count = 0;
+        for(scanline_reader<float> reader("color_image.tif", 16); reader.has_more(); ++reader)
+        {
+            auto rows = *reader;
+            EXPECT_EQ(reader.row(), count);
+            EXPECT_TRUE(rows == image.subarray(shape_t<>{count, 0, 0},
+                                               shape_t<>{count + rows.shape(0), image.shape(1), image.shape(2)}));
+            count += rows.shape(0);
+        }
+        EXPECT_EQ(count, image.shape(0));
+    }
+
+    TEST(image_io, read_image_into)
+    {
+        auto image = read_image<float>("color_image.tif");
+
+        array_nd<float, 3> dense(image.shape());
+        read_image_into("color_image.tif", dense);
+        EXPECT_TRUE(dense == image);
+
+        // channel-first storage, read through a transposed view
+        array_nd<float, 3> planes(shape_t<3>{image.shape(2), image.shape(0), image.shape(1)});
+        read_image_into("color_image.tif", planes.transpose(shape_t<3>{1, 2, 0}));
+        EXPECT_TRUE(planes.transpose(shape_t<3>{1, 2, 0}) == image);
+    }
+
+        // write the pages of 'stack' as subimages of a multi-page file
+    static void write_stack(std::string filename, array_nd<float, 4> const & stack)
+    {
+        OIIO::ImageOutput * out = OIIO::ImageOutput::create(filename);
+        EXPECT_TRUE(out != nullptr);
+        if(out == nullptr)
+        {
+            return;
+        }
+        EXPECT_TRUE(out->supports("multiimage") && out->supports("appendsubimage"));
+        OIIO::ImageSpec spec((int)stack.shape(2), (int)stack.shape(1), (int)stack.shape(3),
+                             OIIO::TypeDesc::FLOAT);
+        for(index_t page=0; page<stack.shape(0); ++page)
+        {
+            bool ok = out->open(filename, spec, page == 0 ? OIIO::ImageOutput::Create
+                                                          : OIIO::ImageOutput::AppendSubimage) &&
+                      out->write_image(OIIO::TypeDesc::FLOAT, stack.bind(0, page).raw_data());
+            EXPECT_TRUE(ok);
+            if(!ok)
+            {
+                break;
+            }
+        }
+        out->close();
+        OIIO::ImageOutput::destroy(out);
+    }
+
+    TEST(image_io, read_volume)
+    {
+        auto image = read_image<float>("color_image.tif");
+        shape_t<4> shape{5, 40, 50, image.shape(2)};
+        array_nd<float, 4> stack(shape);
+        for(index_t page=0; page<shape[0]; ++page)
+        {
+            for(index_t y=0; y<shape[1]; ++y)
+            {
+                for(index_t x=0; x<shape[2]; ++x)
+                {
+                    for(index_t c=0; c<shape[3]; ++c)
+                    {
+                        stack(page, y, x, c) = (page + 1.0f) * image(y + page, x, c);
+                    }
+                }
+            }
+        }
+        write_stack("read_volume_test.tif", stack);
+        EXPECT_EQ(read_image_info("read_volume_test.tif").subimages, shape[0]);
+
+        // more pages than threads, so that each thread reads several slices
+        auto volume = read_volume<float>("read_volume_test.tif", 2);
+        EXPECT_EQ(volume.shape(), (shape_t<>(shape)));
+        for(index_t page=0; page<shape[0]; ++page)
+        {
+            array_nd<float, 3> slice(shape_t<3>{shape[1], shape[2], shape[3]});
+            read_image_into("read_volume_test.tif", slice, page);
+            EXPECT_TRUE(volume.bind(0, page) == slice);
+            EXPECT_TRUE(volume.bind(0, page) == stack.bind(0, page));
+        }
+
+        // a single-page file yields a volume with one slice
+        auto single = read_volume<float>("color_image.tif", 2);
+        EXPECT_EQ(single.shape(), image.shape().insert(0, 1));
+        EXPECT_TRUE(single.bind(0, 0) == image);
+    }
+
+    TEST(image_io, write_image)
+    {
+        auto image = read_image<float>("color_image.tif");
+
+        // write an unevaluated expression
+        write_image("write_image_test.tif", 2.0f * image);
+        EXPECT_TRUE(read_image<float>("write_image_test.tif") == 2.0f * image);
+
+        // PNG doesn't support float => data are normalized to 0...1 during export
+        write_image("write_image_test.png", image.bind(2, 1));
+        auto mM = minmax(read_image<float>("write_image_test.png"))();
+        EXPECT_EQ(mM[0], 0.0f);
+        EXPECT_EQ(mM[1], 1.0f);
+    }
+} // namespace xvigra
@@ -0,0 +1,86 @@
+/************************************************************************/
+/*                                                                      */
+/*     Copyright 2017-2018 by Ullrich Koethe                            */
+/*                                                                      */
+/*    This file is part of the XVIGRA image analysis library.           */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+#include <sstream>
+#include "unittest.hpp"
+#include <xvigra/instrumentation.hpp>
+#include <xvigra/separable_convolution.hpp>
+
+namespace xvigra
+{
+    TEST(instrumentation, scope)
+    {
+        using namespace instrumentation;
+        reset();
+        {
+            scope outer("outer");
+            outer.add_io(10, 40, 80);
+            {
+                scope inner("outer"); // nested call of the same algorithm is not counted again
+                inner.add_io(10, 40, 80);
+                add_temporary(100);
+            }
+            {
+                scope inner("inner");
+                add_temporary(200);
+            }
+        }
+        auto records = registry::global().snapshot();
+        EXPECT_EQ(records.size(), 2u);
+        EXPECT_EQ(records["outer"].calls, 1);
+        EXPECT_EQ(records["outer"].pixels, 10);
+        EXPECT_EQ(records["outer"].bytes_written, 80);
+        EXPECT_EQ(records["outer"].temporary_bytes, 100);
+        EXPECT_EQ(records["inner"].temporaries, 1);
+        EXPECT_EQ(records["inner"].temporary_bytes, 200);
+
+        std::ostringstream json;
+        report_json(json);
+        EXPECT_NE(json.str().find("\"outer\": {\"calls\": 1"), std::string::npos);
+        reset();
+    }
+
+#ifdef XVIGRA_ENABLE_INSTRUMENTATION
+    TEST(instrumentation, functors)
+    {
+        instrumentation::reset();
+        array_nd<float, 2> in(shape_t<2>{20, 30}, 1.0f), out(in.shape());
+        separable_convolution_functor()(in, out, averaging_kernel_1d<float>(1));
+        separable_convolution_functor()(in, out, averaging_kernel_1d<float>(1));
+
+        auto c = instrumentation::registry::global().snapshot()["separable_convolution"];
+        EXPECT_EQ(c.calls, 2);
+        EXPECT_EQ(c.pixels, 2*in.size());
+        EXPECT_EQ(c.bytes_read, 2*in.size()*sizeof(float));
+        EXPECT_EQ(c.temporaries, 2);
+        instrumentation::reset();
+    }
+#endif
+} // namespace xvigra
@@ -285,4 +285,20 @@ namespace xvigra
         // EXPECT_EQ(res, ref_c1);
     }
 
+    TEST(morphology, tiny_vector_pixels)
+    {
+        using P = tiny_vector<uint8_t, 2>;
+        array_nd<uint8_t> img(8*img1), half(4*img1), ref(img.shape(), 0);
+        array_nd<P, 2> vimg(img.shape()), vres(img.shape());
+        vimg.bind_channel(0) = img;
+        vimg.bind_channel(1) = half;
+
+        parabola_erosion(vimg, vres, 2);
+        parabola_erosion(img, ref, 2);
+        EXPECT_TRUE(vres.bind_channel(0) == ref);
+
+        parabola_erosion(half, ref, 2);
+        EXPECT_TRUE(vres.bind_channel(1) == ref);
+    }
+
 } // namespace xvigra
@@ -30,6 +30,7 @@
 
 #include "unittest.hpp"
 #include <xvigra/padding.hpp>
+#include <xvigra/array_nd.hpp>
 #include <xtensor/xarray.hpp>
 #include <xtensor/xtensor.hpp>
 
@@ -96,4 +97,175 @@ namespace xvigra
         }
     }
 
+    TEST(padding, contiguous_views)
+    {
+        xt::xtensor<int, 1> in{1, 2, 3, 4, 5};
+        array_nd<int, 1> vin({5});
+        for(index_t k=0; k<5; ++k)
+        {
+            vin(k) = in(k);
+        }
+        padding_mode modes[] = { zero_padding, repeat_padding, periodic_padding,
+                                 reflect_padding, reflect0_padding };
+        for(auto left : modes)
+        {
+            for(auto right : modes)
+            {
+                xt::xtensor<int, 1> ref = xt::zeros<int>({10});
+                copy_with_padding(in, ref, left, 3, right, 2);
+
+                array_nd<int, 1> out({10}, -1);
+                copy_with_padding(vin, out, left, 3, right, 2);
+
+                // in-place: the input is the interior of the output
+                array_nd<int, 1> inplace({10}, -1);
+                auto interior = inplace.subarray(shape_t<1>{3}, shape_t<1>{8});
+                interior = vin;
+                copy_with_padding(interior, inplace, left, 3, right, 2);
+
+                for(index_t k=0; k<10; ++k)
+                {
+                    EXPECT_EQ(out(k), ref(k));
+                    EXPECT_EQ(inplace(k), ref(k));
+                }
+            }
+        }
+        array_nd<int, 1> out({10});
+        EXPECT_THROW(copy_with_padding(vin, out, periodic_padding, 5, zero_padding, 0), std::runtime_error);
+
+        // no_padding leaves the borders unchanged (element-wise and memmove code paths)
+        using namespace slicing;
+        array_nd<int, 1> strided({10}, 0), unpadded({10}, -1), unpadded_contiguous({10}, -1);
+        for(index_t k=0; k<5; ++k)
+        {
+            strided(2*k) = in(k);
+        }
+        copy_with_padding(strided.view(slice(_,_,2)), unpadded, no_padding, 3, no_padding, 2);
+        copy_with_padding(vin, unpadded_contiguous, no_padding, 3, no_padding, 2);
+        for(index_t k=0; k<10; ++k)
+        {
+            int expected = (k < 3 || k >= 8) ? -1 : in(k-3);
+            EXPECT_EQ(unpadded(k), expected);
+            EXPECT_EQ(unpadded_contiguous(k), expected);
+        }
+    }
+        copy_with_padding(strided.view(slicing::slice(0, 10, 2)), unpadded, no_padding, 3, no_padding, 2);
+        copy_with_padding(vin, out, no_padding, 3, no_padding, 2);
+        for(index_t k=0; k<10; ++k)
+        {
+            int expected = (k < 3 || k >= 8) ? -1 : in(k-3);
+            EXPECT_EQ(unpadded(k), expected);
+            if(k >= 3 && k < 8)
+            {
+                EXPECT_EQ(out(k), expected);
+            }
+        }
+    }
+
+    TEST(padding, pad)
+    {
+        array_nd<int, 2> in({4, 5});
+        for(index_t k=0; k<in.size(); ++k)
+        {
+            in[k] = int(k);
+        }
+        shape_t<2> left{2, 3}, right{1, 2};
+        tiny_vector<padding_mode> left_modes{reflect_padding, periodic_padding},
+                                  right_modes{zero_padding, repeat_padding};
+
+        // reference: pad one axis after the other with copy_with_padding()
+        array_nd<int, 2> ref({7, 10});
+        ref.subarray(left, shape_t<2>{6, 8}) = in;
+        for(index_t d=0; d<2; ++d)
+        {
+            array_nd<int, 1> line({in.shape(d)});
+            for(auto l = ref.lines(d); l.has_more(); ++l)
+            {
+                line = (*l).subarray(shape_t<1>{left[d]}, shape_t<1>{left[d]+in.shape(d)});
+                copy_with_padding(line, *l, left_modes[d], left[d], right_modes[d], right[d]);
+            }
+        }
+
+        auto res = pad(in, left, right, left_modes, right_modes);
+        EXPECT_EQ(res.shape(), ref.shape());
+        EXPECT_EQ(res, ref);
+
+        // a single mode applies to all axes
+        auto zero = pad(in, shape_t<2>{1, 1}, zero_padding);
+        EXPECT_EQ(zero.shape(), (shape_t<2>{6, 7}));
+        EXPECT_EQ(zero(0, 0), 0);
+        EXPECT_EQ(zero(1, 1), in(0, 0));
+        EXPECT_EQ(zero(4, 5), in(3, 4));
+        EXPECT_EQ(zero(5, 6), 0);
+
+        EXPECT_THROW(pad(in, shape_t<2>{4, 1}, reflect_padding), std::runtime_error);
+
+        // input with a zero-extent axis: nothing to read, empty output
+        array_nd<int, 2> empty(shape_t<2>{0, 5});
+        EXPECT_EQ(pad(empty, shape_t<2>{0, 2}, reflect_padding).shape(), (shape_t<2>{0, 9}));
+        auto zero_rows = pad(empty, shape_t<2>{2, 1}, zero_padding);
+        EXPECT_EQ(zero_rows.shape(), (shape_t<2>{4, 7}));
+        for(index_t k=0; k<zero_rows.size(); ++k)
+        {
+            EXPECT_EQ(zero_rows[k], 0);
+        }
+    }
+
+    TEST(padding, copy_with_halo)
+    {
+        array_nd<float, 2> in({6, 8});
+        for(index_t k=0; k<in.size(); ++k)
+        {
+            in[k] = float(k);
+        }
+        shape_t<2> halo{1, 2};
+        tiny_vector<padding_mode> modes{reflect_padding};
+        auto padded = pad(in, halo, halo, modes, modes);
+
+        // interior tile and tile at the lower right corner
+        for(auto begin : {shape_t<2>{2, 4}, shape_t<2>{4, 5}})
+        {
+            array_nd<float, 2> tile({2 + 2*halo[0], 3 + 2*halo[1]});
+            copy_with_halo(in, tile, begin, halo, modes, modes);
+            EXPECT_EQ(tile, padded.subarray(begin, shape_t<2>(begin + tile.shape())));
+        }
+    }
+
+    TEST(padding, padded_view)
+    {
+        array_nd<int, 2> in({5, 6});
+        for(index_t k=0; k<in.size(); ++k)
+        {
+            in[k] = int(k);
+        }
+        tiny_vector<padding_mode> left_modes{reflect_padding, zero_padding},
+                                  right_modes{periodic_padding, repeat_padding};
+        padded_view<int, 2> v(in, left_modes, right_modes);
+        shape_t<2> width{2, 3};
+        auto ref = pad(in, width, width, left_modes, right_modes);
+        for(index_t y=0; y<ref.shape(0); ++y)
+        {
+            for(index_t x=0; x<ref.shape(1); ++x)
+            {
+                EXPECT_EQ(v[shape_t<2>{y-2, x-3}], ref(y, x));
+            }
+        }
+
+        // the interior comes first, and the regions partition the view
+        auto regions = v.regions(shape_t<2>{1, 2}, shape_t<2>{2, 1});
+        EXPECT_FALSE(regions[0].border);
+        EXPECT_EQ(regions[0].begin, (shape_t<2>{1, 2}));
+        EXPECT_EQ(regions[0].end, (shape_t<2>{3, 5}));
+        array_nd<int, 2> count(in.shape(), 0);
+        for(auto const & r : regions)
+        {
+            count.subarray(r.begin, r.end) += 1;
+            EXPECT_EQ(r.border, &r != &regions[0]);
+        }
+        for(index_t k=0; k<count.size(); ++k)
+        {
+            EXPECT_EQ(count[k], 1);
+        }
+    }
+
 } // namespace xvigra
@@ -0,0 +1,90 @@
+/************************************************************************/
+/*                                                                      */
+/*     Copyright 2017-2018 by Ullrich Koethe                            */
+/*                                                                      */
+/*    This file is part of the XVIGRA image analysis library.           */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+
+#include <numeric>
+#include <stdexcept>
+#include "unittest.hpp"
+#include <xvigra/parallel.hpp>
+
+namespace xvigra
+{
+    TEST(parallel, parallel_for)
+    {
+        for(index_t threads: {1, 2, 4})
+        {
+            std::vector<int> count(1000, 0);
+            parallel_for(count.size(),
+                [&](index_t begin, index_t end)
+                {
+                    for(index_t k=begin; k<end; ++k)
+                        ++count[k];
+                },
+                threads, 7);
+            EXPECT_EQ(std::count(count.begin(), count.end(), 1), 1000);
+        }
+
+        EXPECT_THROW(parallel_for(100,
+                        [](index_t begin, index_t)
+                        {
+                            if(begin >= 50)
+                                throw std::runtime_error("error");
+                        },
+                        4, 10),
+                     std::runtime_error);
+    }
+
+    TEST(parallel, parallel_for_lines)
+    {
+        shape_t<3> s{4, 5, 6};
+        array_nd<int, 3> a(s), b(s);
+        std::iota(a.begin(), a.end(), 0);
+
+        for(index_t axis=0; axis<3; ++axis)
+        {
+            b = 0;
+            parallel_for_lines(a, b, axis,
+                [](view_nd<int, 1> in, view_nd<int, 1> out)
+                {
+                    out = 2*in;
+                },
+                4);
+            EXPECT_TRUE(b == 2*a);
+
+            parallel_for_lines(b, axis,
+                [](view_nd<int, 1> line)
+                {
+                    line += 1;
+                },
+                4);
+            EXPECT_TRUE(b == 2*a+1);
+        }
+    }
+} // namespace xvigra
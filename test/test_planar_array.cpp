@@ -0,0 +1,88 @@
+/************************************************************************/
+/*                                                                      */
+/*     Copyright 2017-2018 by Ullrich Koethe                            */
+/*                                                                      */
+/*    This file is part of the XVIGRA image analysis library.           */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+
+#include "unittest.hpp"
+#include <xvigra/planar_array.hpp>
+#include <xvigra/separable_convolution.hpp>
+
+namespace xvigra
+{
+    TEST(planar_array, access)
+    {
+        using P = tiny_vector<float, 3>;
+        shape_t<2> s{4, 5};
+        planar_array_nd<float, 2, 3> a(s);
+
+        EXPECT_EQ(a.dimension(), 2);
+        EXPECT_EQ(a.channels(), 3);
+        EXPECT_EQ(a.shape(), s);
+        EXPECT_EQ(a.planes().channel_axis(), 0);
+        for(index_t c=0; c<3; ++c)
+        {
+            EXPECT_TRUE(a.channel(c).is_contiguous());
+            EXPECT_EQ(a.channel(c).shape(), s);
+        }
+
+        a.set_pixel({1, 2}, P{1.0f, 2.0f, 3.0f});
+        EXPECT_EQ((a[{1, 2}]), (P{1.0f, 2.0f, 3.0f}));
+        EXPECT_EQ((a.channel(2)[{1, 2}]), 3.0f);
+        EXPECT_EQ((a[{0, 0}]), P());
+
+        array_nd<P, 2> interleaved = a.interleaved();
+        EXPECT_EQ((interleaved[{1, 2}]), (P{1.0f, 2.0f, 3.0f}));
+
+        planar_array_nd<float, 2, 3> b(interleaved);
+        EXPECT_TRUE(b.planes() == a.planes());
+
+        planar_array_nd<float, 2, 3> c(b);
+        c.set_pixel({1, 2}, P{4.0f, 5.0f, 6.0f});
+        EXPECT_EQ((b[{1, 2}]), (P{1.0f, 2.0f, 3.0f}));
+        EXPECT_EQ((c[{1, 2}]), (P{4.0f, 5.0f, 6.0f}));
+    }
+
+    TEST(planar_array, separable_convolution)
+    {
+        using P = tiny_vector<float, 3>;
+        shape_t<2> s{20, 30};
+        array_nd<P, 2> in(s), out(s);
+        for(index_t k=0; k<in.size(); ++k)
+        {
+            in[k] = P{float(k % 7), float(k % 11), float(k % 13)};
+        }
+
+        auto && kernel = gaussian_kernel_1d<float>(1.5);
+        separable_convolution(2_d, in.expand_elements(2), out.expand_elements(2), kernel);
+
+        planar_array_nd<float, 2, 3> planar_in(in), planar_out(s);
+        separable_convolution(planar_in, planar_out, kernel);
+        EXPECT_TRUE(allclose(planar_out.interleaved().expand_elements(2), out.expand_elements(2)));
+    }
+} // namespace xvigra
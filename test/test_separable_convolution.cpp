@@ -98,4 +98,220 @@ namespace xvigra
         separable_convolution(2_d, in, out, kernel);
         write_image("smooth.png", out);
     }
+
+    TEST(separable_convolution, interleaved_channels)
+    {
+        auto && kernel = gaussian_kernel_1d<float>(1.0);
+        array_nd<float, 3> in({30, 40, 3}), out(in.shape(), 0), ref(in.shape(), 0);
+        for(index_t k=0; k<in.size(); ++k)
+        {
+            in[k] = float(k % 17);
+        }
+
+        separable_convolution(2_d, in, out, kernel);
+        for(index_t c=0; c<3; ++c)
+        {
+            separable_convolution(in.bind(2, c), ref.bind(2, c), kernel);
+        }
+        EXPECT_TRUE(allclose(out, ref));
+    }
+
+    TEST(separable_convolution, tiny_vector_pixels)
+    {
+        using P = tiny_vector<float, 3>;
+        auto && kernel = gaussian_kernel_1d<float>(1.0);
+        array_nd<P, 2> in({30, 40}), out(in.shape());
+        array_nd<float, 2> ref(in.shape());
+        for(index_t k=0; k<in.size(); ++k)
+        {
+            in[k] = P{float(k % 5), float(k % 7), float(k % 17)};
+        }
+
+        separable_convolution(in, out, kernel);
+        for(index_t c=0; c<3; ++c)
+        {
+            separable_convolution(in.bind_channel(c), ref, kernel);
+            EXPECT_TRUE(allclose(out.bind_channel(c), ref));
+        }
+    }
+
+    TEST(separable_convolution, odd_row_length)
+    {
+        // odd row lengths exercise the aligned kernels and their scalar tails
+        auto && kernel = gaussian_kernel_1d<float>(1.0);
+        array_nd<float, 3> in({9, 11, 37}), out(in.shape(), 0), ref(in.shape(), 0);
+        for(index_t k=0; k<in.size(); ++k)
+        {
+            in[k] = float(k % 13);
+        }
+        separable_convolution(in, out, kernel);
+        slow_separable_convolution(in, ref, kernel);
+        EXPECT_TRUE(allclose(out, ref));
+    }
+
+    TEST(separable_convolution, small_kernels)
+    {
+        // kernels of size 3, 5 and 7 use the unrolled code paths
+        array_nd<float, 2> in({23, 31});
+        for(index_t k=0; k<in.size(); ++k)
+        {
+            in[k] = float(k % 13);
+        }
+        padding_mode modes[] = { reflect_padding, reflect0_padding, repeat_padding,
+                                 periodic_padding, zero_padding };
+        for(index_t size=3; size<=9; size+=2)
+        {
+            kernel_1d<float> kernel(size, 1);  // asymmetric
+            for(index_t k=0; k<size; ++k)
+            {
+                kernel(k) = float(k + 1) / size;
+            }
+            for(auto mode : modes)
+            {
+                auto options = convolution_options().padding(mode);
+                array_nd<float, 2> out(in.shape(), 0), ref(in.shape(), 0);
+                separable_convolution(in, out, kernel, options);
+                slow_separable_convolution(in, ref, kernel, options);
+                EXPECT_TRUE(allclose(out, ref));
+
+                // strided input rows
+                array_nd<float, 2> out_t(in.transpose().shape(), 0), ref_t(in.transpose().shape(), 0);
+                separable_convolution(in.transpose(), out_t, kernel, options);
+                slow_separable_convolution(in.transpose(), ref_t, kernel, options);
+                EXPECT_TRUE(allclose(out_t, ref_t));
+            }
+        }
+    }
+
+    TEST(separable_convolution, strided_double_rows)
+    {
+        // strided rows with a 9-tap kernel go through the padded line buffer,
+        // which must not round the input to float
+        array_nd<double, 2> in({19, 27}), out({27, 19}, 0), ref({27, 19}, 0);
+        for(index_t k=0; k<in.size(); ++k)
+        {
+            in[k] = 1.0 + 1e-9*k;
+        }
+        auto && kernel = averaging_kernel_1d<double>(4);
+        separable_convolution(in.transpose(), out, kernel);
+        slow_separable_convolution(in.transpose(), ref, kernel);
+        EXPECT_TRUE(allclose(out, ref, 1e-14, 0.0));
+    }
+
+    TEST(separable_convolution, strided_rows_no_padding)
+    {
+        // strided rows with a 9-tap kernel and no_padding go through the padded
+        // line buffer, whose borders are left unchanged by copy_with_padding()
+        array_nd<float, 2> in({19, 27}), out({27, 19}, 0), ref({27, 19}, 0);
+        for(index_t k=0; k<in.size(); ++k)
+        {
+            in[k] = float(k % 13);
+        }
+        auto && kernel = averaging_kernel_1d<float>(4);
+        auto options = convolution_options().padding(no_padding);
+        separable_convolution(in.transpose(), out, kernel, options);
+        slow_separable_convolution(in.transpose(), ref, kernel, options);
+        // only the region that is valid along both axes is defined
+        for(index_t y=4; y<out.shape(0)-4; ++y)
+        {
+            for(index_t x=4; x<out.shape(1)-4; ++x)
+            {
+                EXPECT_NEAR(out(y, x), ref(y, x), 1e-5);
+            }
+        }
+    }
+
+    TEST(separable_convolution, output_stride)
+    {
+        // fused downsampling must equal full convolution followed by subsampling
+        array_nd<float, 2> in({23, 31});
+        for(index_t k=0; k<in.size(); ++k)
+        {
+            in[k] = float(k % 13);
+        }
+        padding_mode modes[] = { reflect_padding, reflect0_padding, repeat_padding,
+                                 periodic_padding, zero_padding };
+        kernel_1d<float> kernel(5, 1);  // asymmetric
+        for(index_t k=0; k<5; ++k)
+        {
+            kernel(k) = float(k + 1) / 5;
+        }
+        for(auto mode : modes)
+        {
+            array_nd<float, 2> full(in.shape(), 0);
+            separable_convolution(in, full, kernel, convolution_options().padding(mode));
+
+            array_nd<float, 2> out({12, 11}, 0);
+            separable_convolution(in, out, kernel,
+                                  convolution_options().padding(mode).output_stride(shape_t<2>{2, 3}));
+            for(index_t i=0; i<out.shape(0); ++i)
+            {
+                for(index_t j=0; j<out.shape(1); ++j)
+                {
+                    EXPECT_NEAR(out(i, j), full(2*i, 3*j), 1e-5);
+                }
+            }
+
+            // strided input rows
+            array_nd<float, 2> out_t({16, 12}, 0);
+            separable_convolution(in.transpose(), out_t, kernel,
+                                  convolution_options().padding(mode).output_stride(2));
+            for(index_t i=0; i<out_t.shape(0); ++i)
+            {
+                for(index_t j=0; j<out_t.shape(1); ++j)
+                {
+                    EXPECT_NEAR(out_t(i, j), full(2*j, 2*i), 1e-5);
+                }
+            }
+        }
+
+        auto && gauss = gaussian_kernel_1d<float>(1.0);
+        array_nd<float, 3> in3({9, 11, 37}), full3(in3.shape(), 0), out3({5, 6, 19}, 0);
+        for(index_t k=0; k<in3.size(); ++k)
+        {
+            in3[k] = float(k % 13);
+        }
+        separable_convolution(in3, full3, gauss);
+        separable_convolution(in3, out3, gauss, convolution_options().output_stride(2));
+        for(index_t i=0; i<out3.shape(0); ++i)
+        {
+            for(index_t j=0; j<out3.shape(1); ++j)
+            {
+                for(index_t k=0; k<out3.shape(2); ++k)
+                {
+                    EXPECT_NEAR(out3(i, j, k), full3(2*i, 2*j, 2*k), 1e-5);
+                }
+            }
+        }
+
+        array_nd<float, 2> wrong({11, 16});
+        EXPECT_THROW(separable_convolution(in, wrong, kernel, convolution_options().output_stride(2)),
+                     std::runtime_error);
+    }
+
+    TEST(separable_convolution, output_stride_channels)
+    {
+        // interleaved channels with output strides are convolved channel by channel
+        auto && kernel = gaussian_kernel_1d<float>(1.0);
+        auto options = convolution_options().output_stride(2);
+        array_nd<float, 3> in({30, 41, 3}), out({15, 21, 3}, 0), ref({15, 21, 3}, 0);
+        for(index_t k=0; k<in.size(); ++k)
+        {
+            in[k] = float(k % 17);
+        }
+        for(index_t c=0; c<3; ++c)
+        {
+            separable_convolution(in.bind(2, c), ref.bind(2, c), kernel, options);
+        }
+
+        separable_convolution(2_d, in, out, kernel, options);
+        EXPECT_TRUE(allclose(out, ref));
+
+        // direct call of the interleaved code path
+        separable_convolution_functor f;
+        array_nd<float, 3> merged_out(out.shape(), 0);
+        f.impl_interleaved(0, f.merge_channel_axis(in), f.merge_channel_axis(merged_out),
+                           3, kernel, options);
+        EXPECT_TRUE(allclose(merged_out, ref));
+    }
 } // namespace xvigra
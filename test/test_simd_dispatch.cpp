@@ -0,0 +1,85 @@
+/************************************************************************/
+/*                                                                      */
+/*     Copyright 2017-2018 by Ullrich Koethe                            */
+/*                                                                      */
+/*    This file is part of the XVIGRA image analysis library.           */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+#include <algorithm>
+#include <vector>
+#include "unittest.hpp"
+#include <xvigra/simd_dispatch.hpp>
+
+namespace xvigra
+{
+    TEST(simd_dispatch, isa_selection)
+    {
+        simd_isa detected = detected_simd_isa();
+        EXPECT_LE(active_simd_isa(), detected);
+
+        simd_isa previous = set_simd_isa(scalar_isa);
+        EXPECT_EQ(active_simd_isa(), scalar_isa);
+        set_simd_isa(avx512_isa);  // clamped to the CPU's capabilities
+        EXPECT_EQ(active_simd_isa(), detected);
+        set_simd_isa(previous);
+        EXPECT_EQ(std::string(simd_isa_name(avx2_isa)), "avx2");
+    }
+
+    TEST(simd_dispatch, kernels)
+    {
+        // all variants available on this CPU must agree with the scalar code
+        index_t size = 77;  // not a multiple of any SIMD width or strip
+        std::vector<float> src(size), ref(size), dest(size);
+        std::vector<double> ref_parabola(size, -1.0), parabola(size, -1.0);
+        for(index_t k=0; k<size; ++k)
+        {
+            src[k] = 0.5f*k;
+            ref[k] = 2.0f*src[k] + 3.0f*src[k];
+            if(3 <= k && k < 30)
+                ref_parabola[k] = 0.5*(k - 10.0)*(k - 10.0) + 1.0;
+        }
+
+        simd_isa previous = active_simd_isa();
+        for(int isa = scalar_isa; isa <= detected_simd_isa(); ++isa)
+        {
+            set_simd_isa((simd_isa)isa);
+            detail::dispatch_mul_row(src.data(), size, dest.data(), 2.0f);
+            detail::dispatch_fma_row(src.data(), size, dest.data(), 3.0f);
+            EXPECT_EQ(dest, ref);
+
+            // three taps, exercising both the register-blocked strips and the tail
+            float const * rows[] = { src.data(), src.data(), src.data() };
+            float weights[] = { 1.0f, 1.5f, 2.5f };
+            std::fill(dest.begin(), dest.end(), 0.0f);
+            detail::dispatch_column_row(rows, weights, 3, size, dest.data());
+            EXPECT_EQ(dest, ref);
+
+            detail::dispatch_parabola_row(parabola.data(), 3, 30, 0.5, 10.0, 1.0);
+            EXPECT_EQ(parabola, ref_parabola);
+        }
+        set_simd_isa(previous);
+    }
+} // namespace xvigra
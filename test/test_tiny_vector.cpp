@@ -32,6 +32,7 @@
 #define XVIGRA_ENABLE_ASSERT
 #endif
 
+#include <cfenv>
 #include <numeric>
 #include <limits>
 #include <iostream>
@@ -674,4 +675,55 @@ namespace xvigra
         EXPECT_TRUE((std::is_same<double, norm_type_t<tiny_vector<tiny_vector<int, 1>, 1> > >::value));
         EXPECT_TRUE((std::is_same<tiny_vector<double, SIZE>, decltype(cos(IV()))>::value));
     }
+
+    template <class V>
+    void check_float_arithmetic()
+    {
+        V a(dont_init), b(dont_init);
+        for(index_t k=0; k<a.size(); ++k)
+        {
+            a[k] = 0.5f*(k+1);
+            b[k] = 4.0f - 0.25f*k;
+        }
+        typename V::value_type d = 0;
+        V sum_ab(dont_init), diff_ab(dont_init), prod_ab(dont_init), quot_ab(dont_init),
+          min_ab(dont_init), max_ab(dont_init);
+        for(index_t k=0; k<a.size(); ++k)
+        {
+            sum_ab[k]  = a[k] + b[k];
+            diff_ab[k] = a[k] - b[k];
+            prod_ab[k] = a[k] * b[k];
+            quot_ab[k] = a[k] / b[k];
+            min_ab[k]  = std::min(a[k], b[k]);
+            max_ab[k]  = std::max(a[k], b[k]);
+            d += a[k] * b[k];
+        }
+        EXPECT_EQ(a + b, sum_ab);
+        EXPECT_EQ(a - b, diff_ab);
+        EXPECT_EQ(a * b, prod_ab);
+        EXPECT_EQ(a / b, quot_ab);
+        EXPECT_EQ(min(a, b), min_ab);
+        EXPECT_EQ(max(a, b), max_ab);
+        EXPECT_EQ(dot(a, b), d);
+        EXPECT_EQ(norm_sq(b), dot(b, b));
+    }
+
+    TEST(tiny_vector, float_arithmetic)
+    {
+        check_float_arithmetic<tiny_vector<float, 3>>();
+        check_float_arithmetic<tiny_vector<float, 4>>();
+        check_float_arithmetic<tiny_vector<float, 8>>();
+        check_float_arithmetic<tiny_vector<double, 2>>();
+        check_float_arithmetic<tiny_vector<double, 3>>();
+        check_float_arithmetic<tiny_vector<double, 4>>();
+
+        // the padding lane of size-3 vectors must not divide 0 by 0
+        std::feclearexcept(FE_ALL_EXCEPT);
+        auto q = tiny_vector<float, 3>{1.0f, 2.0f, 3.0f} / tiny_vector<float, 3>{2.0f, 4.0f, 8.0f};
+        EXPECT_FALSE(std::fetestexcept(FE_INVALID));
+        EXPECT_EQ(q, (tiny_vector<float, 3>{0.5f, 0.5f, 0.375f}));
+        auto qd = tiny_vector<double, 3>{1.0, 2.0, 3.0} / tiny_vector<double, 3>{2.0, 4.0, 8.0};
+        EXPECT_FALSE(std::fetestexcept(FE_INVALID));
+        EXPECT_EQ(qd, (tiny_vector<double, 3>{0.5, 0.5, 0.375}));
+    }
 } // namespace xvigra
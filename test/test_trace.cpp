@@ -0,0 +1,98 @@
+/************************************************************************/
+/*                                                                      */
+/*     Copyright 2017-2018 by Ullrich Koethe                            */
+/*                                                                      */
+/*    This file is part of the XVIGRA image analysis library.           */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+#include <sstream>
+#include "unittest.hpp"
+#include <xvigra/trace.hpp>
+#include <xvigra/separable_convolution.hpp>
+
+namespace xvigra
+{
+    TEST(trace, chrome_trace_sink)
+    {
+        std::ostringstream out;
+        {
+            chrome_trace_sink sink(out);
+            trace_sink * previous = set_trace_sink(&sink);
+            {
+                scoped_trace outer("outer", "functor");
+                scoped_trace inner("inner");
+            }
+            set_trace_sink(previous);
+            scoped_trace ignored("ignored"); // no sink installed
+        }
+        std::string json = out.str();
+        EXPECT_EQ(json.front(), '[');
+        EXPECT_NE(json.find("{\"name\": \"outer\", \"cat\": \"functor\", \"ph\": \"B\""), std::string::npos);
+        EXPECT_NE(json.find("{\"name\": \"inner\", \"cat\": \"stage\", \"ph\": \"E\""), std::string::npos);
+        EXPECT_LT(json.find("\"inner\", \"cat\": \"stage\", \"ph\": \"E\""),
+                  json.find("\"outer\", \"cat\": \"functor\", \"ph\": \"E\""));
+        EXPECT_EQ(json.find("ignored"), std::string::npos);
+    }
+
+    TEST(trace, chrome_trace_sink_escaping)
+    {
+        std::ostringstream out;
+        {
+            chrome_trace_sink sink(out);
+            trace_sink * previous = set_trace_sink(&sink);
+            {
+                scoped_trace quoted("say \"hi\"\\tab\tend\n\x01", "user \"stage\"");
+            }
+            set_trace_sink(previous);
+        }
+        std::string json = out.str();
+        EXPECT_NE(json.find("{\"name\": \"say \\\"hi\\\"\\\\tab\\tend\\n\\u0001\", "
+                            "\"cat\": \"user \\\"stage\\\"\", \"ph\": \"B\""), std::string::npos);
+        for(char c: json)
+        {
+            EXPECT_FALSE(c != '\n' && static_cast<unsigned char>(c) < 0x20);
+        }
+    }
+
+#ifdef XVIGRA_ENABLE_TRACING
+    TEST(trace, functors)
+    {
+        std::ostringstream out;
+        {
+            chrome_trace_sink sink(out);
+            set_trace_sink(&sink);
+            array_nd<float, 2> in(shape_t<2>{20, 30}, 1.0f), res(in.shape());
+            separable_convolution_functor()(in, res, averaging_kernel_1d<float>(1));
+            set_trace_sink(nullptr);
+        }
+        std::string json = out.str();
+        EXPECT_NE(json.find("\"separable_convolution\", \"cat\": \"functor\""), std::string::npos);
+        EXPECT_NE(json.find("\"allocate temporary\""), std::string::npos);
+        EXPECT_NE(json.find("\"axis 0\""), std::string::npos);
+        EXPECT_NE(json.find("\"axis 1\""), std::string::npos);
+    }
+#endif
+} // namespace xvigra